@@ -1,29 +1,51 @@
 /*******************************************************************************
 
-    PURPOSE: The purpose of this program is to display a 64x32 grid of Conway's
+    PURPOSE: The purpose of this program is to display a grid of Conway's
              game of life whereby each cell lives, dies, or comes back to life 
              based on the implementation of the rules.
 
     HISTORY: Created by Joseph Santoyo, March 6, 2015
 
-    INPUTS: Any key to continue, 'x' to exit.
-
-    OUTPUTS: The 64x32 randomly generated grid of cells
-
-    ALGORITHM(S): Loops through each row calling an init() function which initi-
-                  alizes the grid with random cells. Each row in the grid is th-
-                  en displayed using a displayBinary() function. 
-
-                  The program then retrieves the next generation by calling a 
-                  sumNeighbours() function twice. One for the NORMAL condition, 
-                  and again for the ZOMBIE condition, bitwise OR-ing the return 
-                  values in order to bring back to life the zombie cells, stor-
-                  ing the results for each row in the grid in a global 
-                  next_generation[] array.
-
-                  The next_generation[] array then replaces the old values in-
-                  side of the global grid[] array and the process starts all
-                  over again.
+    INPUTS: Enter to continue, 'x' to exit. 'w', 'a', 's' and 'd' pan the
+            view, '+' and '-' zoom in and out, no further out than the whole
+            board, and 'f' fits the whole board.
+            '<' steps back one generation and 'g <generation>' jumps to any
+            stored generation, Enter then replays the run forward.
+
+            gol [rows columns] sets the size of the board, 64x32 by default.
+            gol --server <socket> <shm-name> [rows columns [interval_ms]]
+            runs the board as a server instead (see gol_server.h).
+
+            Either form takes --storage heap|anon|huge|file:<path> to choose
+            where the board's memory comes from (see gol_storage.h, the path
+            of a file backed board must not exist yet) and
+            --threads <n> to step it with up to n worker threads.
+            --pin <cpu> pins those threads to consecutive CPUs, starting
+            from the given one.
+
+            --history <n> keeps n generations for stepping back, 1024 by
+            default and 0 for none, with a keyframe every --keyframes <n>,
+            64 by default. --slots <n> sets the depth of the server's
+            shared-memory ring, 8 by default and 0 for no ring. These
+            buffers are always on the heap and in /dev/shm, whatever the
+            storage of the board.
+
+    OUTPUTS: The randomly generated grid of cells, and a report of the time
+             and page faults taken to allocate it on the standard error.
+
+    ALGORITHM(S): Creates a board with the engine library (gol_engine.h) and
+                  seeds it with random cells. The part of the board inside
+                  the viewport is drawn with golRenderViewport() (gol_view.h),
+                  zoomed out so that the whole board fits the terminal if it
+                  is larger.
+
+                  The program then asks the engine for the next generation by
+                  calling golStep() and the process starts all over again.
+
+                  Unless the history is off, every generation is recorded in
+                  a history store (gol_history.h). While stepped back,
+                  generations are drawn from the store instead of the engine
+                  until the replay catches up with the newest one.
 
 *******************************************************************************/
 
@@ -32,9 +54,18 @@
 *******************************************************************************/
 
 
+#include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
 #include <time.h>
+#include <unistd.h>
+
+#include "gol_engine.h"
+#include "gol_history.h"
+#include "gol_server.h"
+#include "gol_view.h"
 
 
 /*******************************************************************************
@@ -42,29 +73,12 @@
 *******************************************************************************/
 
 
-// LMASK checks the left-most bit RMASK checks the right-most bit
-#define LMASK 0x8000000000000000
-#define RMASK 0x0000000000000001
-
 // size of grid
 #define SIZE   32      
 
-// cell conditions
-#define NORMAL 0    
-#define ZOMBIE 1   
-
-// compass directions
-#define TOP          0
-#define BOTTOM       1
-#define LEFT         2
-#define RIGHT        3
-#define TOP_LEFT     4
-#define TOP_RIGHT    5
-#define BOTTOM_LEFT  6
-#define BOTTOM_RIGHT 7
-
-// number of compass directions
-#define DIRECTIONS   8
+// terminal size used when it can not be queried
+#define SCREEN_HEIGHT 24
+#define SCREEN_WIDTH  80
 
 
 /*******************************************************************************
@@ -72,32 +86,28 @@
 *******************************************************************************/
 
 
-// data type used for the cells to create 64 cells per row
-typedef unsigned long long int uLLInt;
+// finds the size of the terminal, less a line for the status and prompt
+void screenSize(size_t *, size_t *);
+
+// takes the storage options out of the command line
+int storageOptions(int *, char *[], GolStorageOptions *);
+
+// takes the history and ring options out of the command line
+int bufferOptions(int *, char *[], GolServerOptions *);
 
-// directional function prototypes
-uLLInt TL(int, int);
-uLLInt T(int, int);
-uLLInt TR(int, int);
-uLLInt L(int, int);
-uLLInt R(int, int);
-uLLInt BL(int, int);
-uLLInt B(int, int);
-uLLInt BR(int, int);
+// outputs the allocation report of a board
+void printReport(const GolBoard *);
 
-// checks the number of neighbours a cell has for each cell in a row
-uLLInt sumNeighbours(int, int);
+// explains why a board could not be created
+void printCreateError(size_t, size_t, const GolStorageOptions *);
 
-// outputs the cells
-void displayBinary(uLLInt);
+// set from the signal handler when the server is asked to terminate
+static volatile sig_atomic_t interrupted = 0;
 
-// initializes the grid with random cells
-uLLInt init(void);
+void onSignal(int);
 
-// globally declared playing grid
-uLLInt grid[SIZE] = {0};
-// next generation of cells to display
-uLLInt next_generation[SIZE] = {0};
+// runs the board as a server
+int serverMain(int, char *[], const GolStorageOptions *, GolServerOptions *);
 
 
 /*******************************************************************************
@@ -105,658 +115,405 @@ uLLInt next_generation[SIZE] = {0};
 *******************************************************************************/
 
 
-int main(void)
+int main(int argc, char *argv[])
 {   
 
-    //initialize grid with random cell states
-    srand(time(NULL));
-    int i;
-    for(i = 0; i < SIZE; i++) {
-        grid[i] = init();
+    GolStorageOptions options = {GOL_STORAGE_HEAP, NULL, 1, 0, 0};
+    // history and ring depths, shared with the server's defaults
+    GolServerOptions buffers = GOL_SERVER_DEFAULTS;
+    if (storageOptions(&argc, argv, &options) != 0 ||
+        bufferOptions(&argc, argv, &buffers) != 0) {
+        fprintf(stderr, "usage: %s [--storage heap|anon|huge|file:<path>] "
+                "[--threads <n>] [--pin <cpu>] [--history <n>] "
+                "[--keyframes <n>] [--slots <n>] ...\n", argv[0]);
+        return EXIT_FAILURE;
     }
 
-    // output the grid
-    char c;
-    do {
-        system("clear");
-
-        // display current generation of grid
-        for (i = 0; i < SIZE; i++) {
-            displayBinary(grid[i]);
-            printf("\n");
-        }
-        // get the next generation
-        for (i = 0; i < SIZE; i++) {
-            next_generation[i] = (sumNeighbours(i, NORMAL) |
-                sumNeighbours(i, ZOMBIE));
-        }
-        // replace the current generation with the next generation
-        for (i = 0; i < SIZE; i++) {
-            grid[i] = next_generation[i];
-        }
-
-
-    } while((c = getchar()) != 'x');
-
-    return EXIT_SUCCESS;
-}
-
-/*******************************************************************************
-
-    PURPOSE: To return a randomized row
-
-    HISTORY: Created by D. Houtman
-
-    INPUTS: NONE
-
-    OUTPUTS: A random 64-bit uLLInt
-
-    ALGORITHM(S): Provided by D. Houtman
-
-*******************************************************************************/
-    
-uLLInt init() {
-    uLLInt init64;
-
-    init64 = rand();
-    init64 <<= 2;
-    init64 |= (0x00000003 & rand());
-    init64 <<= 31;
-    init64 |= rand();
-
-    return init64;
-}
-
-/*******************************************************************************
-
-    PURPOSE: To visually display rows of cells as the ASCII values 'x' and ' '
-
-    HISTORY: Created by D. Houtman
-
-    INPUTS: An uLLInt row.
-
-    OUTPUTS: NONE
+    if (argc > 1 && strcmp(argv[1], "--server") == 0) {
+        return serverMain(argc, argv, &options, &buffers);
+    }
 
-    ALGORITHM(S): Assign MASK to the value 0x80000000000000000 which is just an
-                  left-bit-mask that has a 1 on it's left most bit. Bitwise and
-                  the row with the mask, if that returns true (1), output an x
-                  otherwise output a space. Shift the bit in the mask over by 1,
-                  repeat.
+    size_t rows = SIZE;
+    size_t columns = GOL_WORD_BITS;
+    if (argc == 3) {
+        rows = strtoull(argv[1], NULL, 10);
+        columns = strtoull(argv[2], NULL, 10);
+    } else if (argc != 1) {
+        fprintf(stderr, "usage: %s [rows columns]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
 
-    NOTES: Though the function doesn't 'OUTPUT' anything per say, it does displa
-           y a row using the characters 'x' and ' ' where 'x' represents a live
-           cell and ' ' a dead cell. 
+    //initialize grid with random cell states
+    GolBoard *board = golCreateWith(rows, columns, &options);
+    if (board == NULL) {
+        printCreateError(rows, columns, &options);
+        return EXIT_FAILURE;
+    }
+    golSeed(board, time(NULL));
+
+    GolHistory *history = NULL;
+    if (buffers.history > 0) {
+        history = golHistoryCreate(rows, golWords(board), buffers.history,
+                                   buffers.keyframes);
+        if (history == NULL) {
+            fprintf(stderr, "gol: could not create the history\n");
+            golDestroy(board);
+            return EXIT_FAILURE;
+        }
+    }
+    // shown once on the status line, when a generation was not kept
+    const char *note = "";
+    if (history != NULL && golHistoryRecord(history, golCells(board),
+                                            golGeneration(board)) !=
+                           GOL_SUCCESS) {
+        note = ", not kept in the history";
+    }
 
-*******************************************************************************/
+    // generation on screen, behind the engine's while stepped back
+    unsigned long long shown = golGeneration(board);
 
-void displayBinary(uLLInt row) {
-    uLLInt MASK = LMASK;
+    GolViewport view = {0};
+    screenSize(&view.height, &view.width);
+    view.zoom = golViewFit(rows, columns, view.height, view.width);
 
+    // output the grid
+    char line[16];
     do {
-        // output an X if the bit is 1, otherwise a space if it is 0
-        printf("%c", (row & MASK) ? 'x' : 0x20);
-    } while((MASK >>=1) != 0);
-}
-
-/*******************************************************************************
-
-    PURPOSE: To count the number of neighbours surrounding a cell
-
-    HISTORY: Created by D. Houtman, Modified by Joseph Santoyo, March 6, 2015
-
-    INPUTS: An int row, and an int condition (NORMAL OR ZOMBIE)
-
-    OUTPUTS: An uLLInt next_generation which represents the next generation of
-             the row being passed in.
-
-    ALGORITHM(S): Initialize an array which represents the neighbours surroundi-
-                  ng a cell. For each of the 8 directional positions around a 
-                  cell, call the functions corresponding to those positions.
-
-                  Set a mask corresponding to a left bit-mask, initialize a 
-                  uLLInt next_generation to 0.
-
-                  While the mask has not shifted off the end, iterate through
-                  each of the 8 directional positions and sum up all the 1's
-                  in the column of wherever the mask is currently positioned,
-                  store the total in total_alive_neighbours.
-
-                  If the condition provided is NORMAL and the number of alive
-                  neighbours is either 2 or 3, keep that cell alive.
-
-                  If the condition is ZOMBIE and the number of total alive neigh
-                  bours is 3, revive the zombie cell.
-
-                  Shift the mask of a column and repeat if the mask has not 
-                  shifted off the end.
-
-*******************************************************************************/
+        system("clear");
 
-uLLInt sumNeighbours(int row, int condition) {
-    uLLInt neighbours[DIRECTIONS] = {0};
-
-    neighbours[TOP] = T(row, condition);
-    neighbours[RIGHT] = R(row, condition);
-    neighbours[BOTTOM] = B(row, condition);
-    neighbours[LEFT] = L(row, condition);
-    neighbours[TOP_RIGHT] = TR(row, condition);
-    neighbours[TOP_LEFT] = TL(row, condition);
-    neighbours[BOTTOM_LEFT] = BL(row, condition);
-    neighbours[BOTTOM_RIGHT] = BR(row, condition);
-
-    uLLInt MASK = LMASK;
-    uLLInt next_generation = 0;
-    while (MASK) {
-        int total_alive_neighbours = 0;
-        
-        for (unsigned int compass = 0; compass < DIRECTIONS; compass++) {
-            total_alive_neighbours += ((MASK & neighbours[compass]) > 0);
+        // display current generation of grid
+        screenSize(&view.height, &view.width);
+        const uLLInt *cells = golCells(board);
+        if (shown != golGeneration(board)) {
+            cells = golHistorySeek(history, shown);
         }
-
-        if ((condition == NORMAL) &&  
-            (total_alive_neighbours == 2 || total_alive_neighbours == 3)) {
-            // keep that cell alive
-            next_generation |= MASK;
+        if (cells == NULL) {
+            // the generation has dropped out of the history
+            shown = golGeneration(board);
+            cells = golCells(board);
         }
-        if ((condition == ZOMBIE) && total_alive_neighbours == 3) {
-            // revive the cell
-            next_generation |= MASK;
+        golRenderViewport(cells, rows, golWords(board), &view, stdout);
+        printf("generation %llu of %llu%s, zoom %zu, at %zu,%zu > ",
+               shown, golGeneration(board), note, view.zoom, view.row,
+               view.column);
+        fflush(stdout);
+        note = "";
+
+        if (fgets(line, sizeof(line), stdin) == NULL) {
+            break;
         }
 
-        MASK >>= 1;
-    }
-
-    return next_generation;
-}
-
-/*******************************************************************************
-
-    PURPOSE: To find out how many alive cells a row of cells has above it
-
-    HISTORY: Created by Joseph Santoyo, March 6, 2015
-
-    INPUTS: A row number and condition, both ints.
-
-    OUTPUTS: The uLLInt representing the alive cells above the row provided
-
-    ALGORITHM(S): Set upper to the row above the one being passed, adding the
-                  size of the array due to C's peculiar functionality with the % 
-                  operator. Wrap the upper row around if it goes beyond the 
-                  top of the grid.
-
-                  Set lower to the row being passed.
-
-                  If the condition is a NORMAL condition bit-wise and the upper
-                  row with the lower row and return the result.
-
-                  If the condition is a ZOMBIE condition bit-wise and the upper
-                  row with a negated lower row (effectively turning on the 
-                  Zombie cells temporarily). Return that result.
-
-
-*******************************************************************************/
-
-uLLInt T(int row, int condition) {
-    // upper and lower rows being compared
-    int upper, lower;
+        // pan by half a screen
+        unsigned long long wanted;
+        size_t down = view.height * view.zoom / 2;
+        size_t across = view.width * view.zoom / 2;
+
+        // zoom out no further than needed to show the whole board
+        size_t fit = golViewFit(rows, columns, view.height, view.width);
+
+        switch (line[0]) {
+            case 'w':
+                view.row -= view.row < down ? view.row : down;
+                break;
+            case 's':
+                view.row = view.row + down < rows ? view.row + down : view.row;
+                break;
+            case 'a':
+                view.column -= view.column < across ? view.column : across;
+                break;
+            case 'd':
+                view.column = view.column + across < columns ?
+                              view.column + across : view.column;
+                break;
+            case '+':
+                view.zoom = view.zoom > 1 ? view.zoom / 2 : 1;
+                break;
+            case '-':
+                if (view.zoom < fit) {
+                    view.zoom = view.zoom * 2 < fit ? view.zoom * 2 : fit;
+                }
+                break;
+            case 'f':
+                view.row = view.column = 0;
+                view.zoom = golViewFit(rows, columns, view.height, view.width);
+                break;
+            case '<':
+                if (history == NULL) {
+                    note = ", the history is off";
+                } else if (shown > 0 &&
+                           golHistorySeek(history, shown - 1) != NULL) {
+                    shown--;
+                }
+                break;
+            case 'g':
+                if (history == NULL) {
+                    note = ", the history is off";
+                } else if (sscanf(line + 1, "%llu", &wanted) == 1 &&
+                    (wanted == golGeneration(board) ||
+                     golHistorySeek(history, wanted) != NULL)) {
+                    shown = wanted;
+                }
+                break;
+            case 'x':
+                break;
+            default:
+                if (shown < golGeneration(board)) {
+                    // replay the next stored generation
+                    shown++;
+                    break;
+                }
+                // get the next generation
+                golStep(board, 1);
+                if (history != NULL &&
+                    golHistoryRecord(history, golCells(board),
+                                     golGeneration(board)) != GOL_SUCCESS) {
+                    note = ", not kept in the history";
+                }
+                shown = golGeneration(board);
+                break;
+        }
 
-    // set upper to the row above the one being passed
-    upper = (row + SIZE - 1);
-    // wrap the upper row around if it goes beyond the top of the grid
-    upper %= SIZE;
+    } while(line[0] != 'x');
 
-    // set lower to the row being passed
-    lower = row;
-    
-    if (condition == NORMAL) {
-        return grid[upper] & grid[lower];
-    }
+    printReport(board);
+    golHistoryDestroy(history);
+    golDestroy(board);
 
-    if (condition == ZOMBIE) {
-        // make the dead cells alive and the alive cells dead so you can check
-        // whether or not zombie cells have any live neighbours above
-        return grid[upper] & (~grid[lower]);
-    }
+    return EXIT_SUCCESS;
 }
 
 /*******************************************************************************
 
-    PURPOSE: To determine the live cells below a row being passed in.
-
-    HISTORY: Created by Joseph Santoyo, March 6, 2015
-
-    INPUTS: A row number and condition, both ints.
-
-    OUTPUTS: A uLLInt representing the live cells below a row
+    PURPOSE: To find how much of the terminal the board can be drawn on
 
-    ALGORITHM(S): Set upper to the row being passed and lower to the row below
-                  the one being passed. Wrap the lower row around if it goes 
-                  beyond the bottom of the grid.
+    INPUTS: Pointers receiving the height and width in characters.
 
-                  If the condition is NORMAL bit-wise and the upper and lower
-                  rows. Return the result.
+    OUTPUTS: NONE
 
-                  If the condition is ZOMBIE, negate the upper row (temporarily
-                  turning on the zombie cells) and bit-wise and that with the
-                  lower row. Return the result.
+    ALGORITHM(S): Ask the terminal for its size, falling back to 80x24 when
+                  the output is not a terminal. One line is kept free for
+                  the status and prompt.
 
 *******************************************************************************/
 
-uLLInt B(int row, int condition) {
-    // upper and lower rows being compared
-    int upper, lower;
+void screenSize(size_t *height, size_t *width) {
+    struct winsize size;
 
-    // set upper to the row being passed
-    upper = row;
-
-    // set lower to the row below the one being passed
-    lower = row + 1;
-
-    // wrap the lower row around if it goes beyond the bottom of the grid
-    lower %= SIZE;
-    
-    if (condition == NORMAL) {
-        return grid[upper] & grid[lower];
-    }
-
-    if (condition == ZOMBIE) {
-        return (~grid[upper]) & grid[lower];
+    *height = SCREEN_HEIGHT;
+    *width = SCREEN_WIDTH;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0 &&
+        size.ws_row > 1 && size.ws_col > 0) {
+        *height = size.ws_row;
+        *width = size.ws_col;
     }
+    *height -= 1;
 }
 
 /*******************************************************************************
 
-    PURPOSE: To determine which cells left of the row being passed, are alive.
-
-    HISTORY: Created by Joseph Santoyo, March 6, 2015
-
-    INPUTS: A row number and condition, both ints.
+    PURPOSE: To take the storage options out of the command line
 
-    OUTPUTS: A row representing the live cells to the left of the row being
-             passed.
+    INPUTS: The argument count and vector, and the options to fill in.
 
-    ALGORITHM(S): Set the row you want to shift to a variable called
-                  shifted_row.
-
-                  If the condition is NORMAL, check if there is a live cell on
-                  the rightmost bit, if there is, shift the row over to the right 
-                  by 1, and set the leftmost bit on, effectively wrapping the 
-                  row's cells.
-
-                  Bit-wise AND this shifted row with the row you want to check. 
-                  Return the result.
-
-                  If there is no live cell on the right most bit, then shift
-                  the row to the right without accounting for wrapping and bit-w
-                  ise AND this shifted row with the row you want to check.
-
-                  The same will be done for zombie rows except you will be temp-
-                  orarily turning on the zombies in the row you are checking be-
-                  fore bit-wise ANDing the shifted row with the zombie row. 
+    OUTPUTS: 0 on success, -1 if an option is missing its value or has an
+             unknown one. The options and their values are removed from argv
+             and argc is reduced to match.
 
 *******************************************************************************/
 
-uLLInt L(int row, int condition) {
-    // the row being shifted
-    uLLInt shifted_row = grid[row];
-
-    if (condition == NORMAL) {
-        // check for a bit that needs to be wrapped around
-        if (grid[row] & RMASK) {
-            // shift the row by 1
-            shifted_row = (shifted_row >> 1) | LMASK;
-            // check if there is a left neighbour after shifting it over
-            return grid[row] & shifted_row;
+int storageOptions(int *argc, char *argv[], GolStorageOptions *options) {
+    int i, kept = 1;
+
+    for (i = 1; i < *argc; i++) {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < *argc) {
+            options->threads = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--pin") == 0 && i + 1 < *argc) {
+            options->pin = 1;
+            options->first_cpu = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--storage") == 0 && i + 1 < *argc) {
+            const char *kind = argv[++i];
+            if (strcmp(kind, "heap") == 0) {
+                options->kind = GOL_STORAGE_HEAP;
+            } else if (strcmp(kind, "anon") == 0) {
+                options->kind = GOL_STORAGE_ANON;
+            } else if (strcmp(kind, "huge") == 0) {
+                options->kind = GOL_STORAGE_HUGE;
+            } else if (strncmp(kind, "file:", 5) == 0 && kind[5] != '\0') {
+                options->kind = GOL_STORAGE_FILE;
+                options->path = kind + 5;
+            } else {
+                return -1;
+            }
+        } else if (strcmp(argv[i], "--threads") == 0 ||
+                   strcmp(argv[i], "--pin") == 0 ||
+                   strcmp(argv[i], "--storage") == 0) {
+            return -1;
         } else {
-            return grid[row] & (shifted_row >> 1);
+            argv[kept++] = argv[i];
         }
-        
     }
 
-    if (condition == ZOMBIE) {
-        // check for a bit that needs to be wrapped around
-        if (grid[row] & RMASK) {
-            // shift the row by 1
-            shifted_row = (shifted_row >> 1) | LMASK;
-            // check if there is a left neighbour after shifting it over
-            return (~grid[row]) & shifted_row;
-        } else {
-            return (~grid[row]) & (shifted_row >> 1);
-        }
-    }
+    *argc = kept;
+    argv[kept] = NULL;
+    return 0;
 }
 
 /*******************************************************************************
 
-    PURPOSE: To determine which cells right of the row being passed, are alive.
-
-    HISTORY: Created by Joseph Santoyo, March 6, 2015
-
-    INPUTS: A row number and condition, both ints.
-
-    OUTPUTS: A row representing the live cells to the right of the row being
-             passed.
-
-    ALGORITHM(S): Set the row you want to shift to a variable called
-                  shifted_row.
+    PURPOSE: To take the history and ring options out of the command line
 
-                  If the condition is NORMAL, check if there is a live cell on
-                  the leftmost bit, if there is, shift the row over to the left 
-                  by 1, and set the rightmost bit on, effectively wrapping the 
-                  row's cells.
-
-                  Bit-wise AND this shifted row with the row you want to check. 
-                  Return the result.
-
-                  If there is no live cell on the left most bit, then shift
-                  the row to the left without accounting for wrapping and bit-w
-                  ise AND this shifted row with the row you want to check.
-
-                  The same will be done for zombie rows except you will be temp-
-                  orarily turning on the zombies in the row you are checking be-
-                  fore bit-wise ANDing the shifted row with the zombie row. 
+    INPUTS: The argument count and vector, and the options to fill in.
 
+    OUTPUTS: 0 on success, -1 if an option is missing its value. The options
+             and their values are removed from argv and argc is reduced to
+             match.
 
 *******************************************************************************/
 
-uLLInt R(int row, int condition) {
-    // the row being shifted
-    uLLInt shifted_row = grid[row];
-    if (condition == NORMAL) {
-        // check for a bit that needs to be wrapped around
-        if (grid[row] & LMASK) {
-            // shift the row by 1
-            shifted_row = ((shifted_row << 1) | RMASK);
-            // check if there is a left neighbour after shifting it over
-            return (grid[row] & shifted_row);
-        } else {
-            return (grid[row] & (shifted_row << 1));
+int bufferOptions(int *argc, char *argv[], GolServerOptions *options) {
+    int i, kept = 1;
+
+    for (i = 1; i < *argc; i++) {
+        size_t *value = NULL;
+        if (strcmp(argv[i], "--history") == 0) {
+            value = &options->history;
+        } else if (strcmp(argv[i], "--keyframes") == 0) {
+            value = &options->keyframes;
+        } else if (strcmp(argv[i], "--slots") == 0) {
+            value = &options->slots;
         }
-    }
 
-    if (condition == ZOMBIE) {
-        // check for a bit that needs to be wrapped around
-        if (grid[row] & LMASK) {
-            // shift the row by 1
-            shifted_row = ((shifted_row << 1) | RMASK);
-            // check if there is a left neighbour after shifting it over
-            return ((~grid[row]) & shifted_row);
+        if (value == NULL) {
+            argv[kept++] = argv[i];
+        } else if (i + 1 < *argc) {
+            *value = strtoull(argv[++i], NULL, 10);
         } else {
-            return ((~grid[row]) & (shifted_row << 1));
+            return -1;
         }
     }
+
+    *argc = kept;
+    argv[kept] = NULL;
+    return 0;
 }
 
 /*******************************************************************************
 
-    PURPOSE: To determine which cells in the row being passed have live cells
-             to their top left.
+    PURPOSE: To show what allocating the board cost
 
-    HISTORY: Created by Joseph Santoyo, March 6, 2015
-
-    INPUTS: A row number and condition, both ints.
-
-    OUTPUTS: A row representing the live cells to the top left of the row being
-             passed.
+    INPUTS: A board.
 
-    ALGORITHM(S): This function is a combination of the logic contained within
-                  both T() and L() functions. Essentially, You are shifting
-                  the upper row to the right and bitwise AND-ing it with the
-                  upper row.
-
-                  For the ZOMBIE condition you are negating the
-                  lower row to flip the cells from dead to alive temporarily
-                  and bitwise ANDing it with the shifted row.
+    OUTPUTS: NONE
 
-                  The result of this is being returned.
+    NOTES: Though the function doesn't 'OUTPUT' anything per say, it does print
+           one line on the standard error with the storage kind, its size,
+           the time taken and the page faults seen.
 
 *******************************************************************************/
 
-uLLInt TL(int row, int condition) {
-    // upper and lower rows being compared
-    int upper, lower;
-
-    // set upper to the row above the one being passed
-    upper = row + SIZE - 1;
-    // wrap the upper row around if it goes beyond the top of the grid
-    upper %= SIZE;
-
-    // set lower to the row being passed
-    lower = row;
-
-    // the row being shifted
-    uLLInt shifted_row = grid[upper];
-
-    if (condition == NORMAL) {
-        // check for a bit that needs to be wrapped around
-        if (grid[upper] & RMASK) {
-            // shift the row by 1
-            shifted_row = ((shifted_row >> 1) | LMASK);
-            // check if there is a left neighbour after shifting it over
-            return (grid[lower] & shifted_row);
-        } else {
-            return (grid[lower] & (shifted_row >> 1));
-        }
-        
-    }
-
-    if (condition == ZOMBIE) {
-        // check for a bit that needs to be wrapped around
-        if (grid[upper] & RMASK) {
-            // shift the upper by 1
-            shifted_row = ((shifted_row >> 1) | LMASK);
-            // check if there is a left neighbour after shifting it over
-            return ((~grid[lower]) & shifted_row);
-        } else {
-            return ((~grid[lower]) & (shifted_row >> 1));
-        }
-    }
+void printReport(const GolBoard *board) {
+    const GolStorageReport *report = golAllocationReport(board);
 
+    fprintf(stderr, "gol: %s storage, %.1f MB%s, allocated in %.3f ms with "
+            "%ld minor and %ld major page faults\n",
+            golStorageName(report->kind), report->bytes / (1024.0 * 1024.0),
+            report->huge_pages ? " on huge pages" : "",
+            report->milliseconds, report->minor_faults,
+            report->major_faults);
 }
 
 /*******************************************************************************
 
-    PURPOSE: To determine which cells in the row being passed have live cells
-             to their top right.
-
-    HISTORY: Created by Joseph Santoyo, March 6, 2015
-
-    INPUTS: A row number and condition, both ints.
-
-    OUTPUTS: A row representing the live cells to the top right of the row being
-             passed.
-
-    ALGORITHM(S): This function is a combination of the logic contained within
-                  both T() and R() functions. Essentially, You are shifting
-                  the upper row to the left and bitwise AND-ing it with the
-                  lower row.
+    PURPOSE: To explain why a board could not be created
 
-                  For the ZOMBIE condition you are negating the
-                  lower row to flip the cells from dead to alive temporarily
-                  and bitwise ANDing it with the shifted row.
+    INPUTS: The rows and columns asked for and the storage options.
 
-                  The result of this is being returned.
+    OUTPUTS: NONE, one line is printed on the standard error.
 
 *******************************************************************************/
 
-uLLInt TR(int row, int condition) {
-    // upper and lower rows being compared
-    int upper, lower;
-
-    // set upper to the row above the one being passed
-    upper = row + SIZE - 1;
-    // wrap the upper row around if it goes beyond the top of the grid
-    upper %= SIZE;
-
-    // set lower to the row being passed
-    lower = row;
-
-    // the row being shifted
-    uLLInt shifted_row = grid[upper];
-
-    if (condition == NORMAL) {
-        // check for a bit that needs to be wrapped around
-        if (grid[upper] & LMASK) {
-            // shift the row by 1
-            shifted_row = ((shifted_row << 1) | RMASK);
-            // check if there is a left neighbour after shifting it over
-            return (grid[lower] & shifted_row);
-        } else {
-            return (grid[lower] & (shifted_row << 1));
-        }
-        
-    }
-
-    if (condition == ZOMBIE) {
-        // check for a bit that needs to be wrapped around
-        if (grid[upper] & LMASK) {
-            // shift the upper by 1
-            shifted_row = ((shifted_row << 1) | RMASK);
-            // check if there is a left neighbour after shifting it over
-            return ((~grid[lower]) & shifted_row);
-        } else {
-            return ((~grid[lower]) & (shifted_row << 1));
-        }
-    }
-
+void printCreateError(size_t rows, size_t columns,
+                      const GolStorageOptions *options) {
+    fprintf(stderr, "gol: could not create a %zux%zu board in %s storage "
+            "(columns must be a multiple of %d, and the file of a file "
+            "backed board must not exist yet)\n", columns, rows,
+            golStorageName(options->kind), GOL_WORD_BITS);
 }
 
 /*******************************************************************************
 
-    PURPOSE: To determine which cells in the row being passed have live cells
-             to their bottom left.
-
-    HISTORY: Created by Joseph Santoyo, March 6, 2015
-
-    INPUTS: A row number and condition, both ints.
+    PURPOSE: To run a randomly seeded board as a server
 
-    OUTPUTS: A row representing the live cells to the bottom left of the row 
-             being passed.
+    INPUTS: The command line: --server <socket> <shm-name>, optionally
+            followed by the rows and columns of the board and the time
+            between generations in milliseconds.
 
-    ALGORITHM(S): This function is a combination of the logic contained within
-                  both B() and L() functions. Essentially, You are shifting
-                  the lower row to the right and bitwise AND-ing it with the
-                  upper row. 
-
-                  For the ZOMBIE condition you are negating the
-                  upper row to flip the cells from dead to alive temporarily
-                  and bitwise ANDing it with the shifted row.
-
-                  The result of this is being returned.
+            The storage, history and ring options already taken out of the
+            command line.
 
+    OUTPUTS: EXIT_SUCCESS once the server is stopped, EXIT_FAILURE otherwise.
 
 *******************************************************************************/
 
-uLLInt BL(int row, int condition) {
-    // upper and lower rows being compared
-    int upper, lower;
-
-    // set upper to the row being passed
-    upper = row;
-
-    // set lower to the row below the one being passed
-    lower = row + 1;
-
-    // wrap the lower row around if it goes beyond the bottom of the grid
-    lower %= SIZE;
-
-    // the row being shifted
-    uLLInt shifted_row = grid[lower];
+int serverMain(int argc, char *argv[], const GolStorageOptions *options,
+               GolServerOptions *buffers) {
+    size_t rows = SIZE;
+    size_t columns = GOL_WORD_BITS;
 
-    if (condition == NORMAL) {
-        // check for a bit that needs to be wrapped around
-        if (grid[lower] & RMASK) {
-            // shift the row by 1
-            shifted_row = ((shifted_row >> 1) | LMASK);
-            // check if there is a left neighbour after shifting it over
-            return (grid[upper] & shifted_row);
-        } else {
-            return (grid[upper] & (shifted_row >> 1));
-        }
-        
+    if (argc < 4 || argc == 5 || argc > 7) {
+        fprintf(stderr, "usage: %s --server <socket> <shm-name> "
+                "[rows columns [interval_ms]]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (argc >= 6) {
+        rows = strtoull(argv[4], NULL, 10);
+        columns = strtoull(argv[5], NULL, 10);
+    }
+    if (argc == 7) {
+        buffers->interval_ms = strtol(argv[6], NULL, 10);
     }
 
-    if (condition == ZOMBIE) {
-        // check for a bit that needs to be wrapped around
-        if (grid[lower] & RMASK) {
-            // shift the upper by 1
-            shifted_row = ((shifted_row >> 1) | LMASK);
-            // check if there is a left neighbour after shifting it over
-            return ((~grid[upper]) & shifted_row);
-        } else {
-            return ((~grid[upper]) & (shifted_row >> 1));
-        }
+    GolBoard *board = golCreateWith(rows, columns, options);
+    if (board == NULL) {
+        printCreateError(rows, columns, options);
+        return EXIT_FAILURE;
     }
+    printReport(board);
+    golSeed(board, time(NULL));
+
+    // stop on SIGINT and SIGTERM, then put the old handlers back
+    struct sigaction action, old_interrupt, old_terminate;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = onSignal;
+    sigaction(SIGINT, &action, &old_interrupt);
+    sigaction(SIGTERM, &action, &old_terminate);
+
+    buffers->stop = &interrupted;
+    int result = golServe(board, argv[2], argv[3], buffers);
+
+    sigaction(SIGINT, &old_interrupt, NULL);
+    sigaction(SIGTERM, &old_terminate, NULL);
+    if (result != GOL_SUCCESS) {
+        fprintf(stderr, "gol: could not serve on %s and %s\n",
+                argv[2], argv[3]);
+    }
+
+    golDestroy(board);
 
+    return result == GOL_SUCCESS ? EXIT_SUCCESS : EXIT_FAILURE;
 }
 
 /*******************************************************************************
 
-    PURPOSE: To determine which cells in the row being passed have live cells
-             to their bottom right.
-
-    HISTORY: Created by Joseph Santoyo, March 6, 2015
-
-    INPUTS: A row number and condition, both ints.
-
-    OUTPUTS: A row representing the live cells to the bottom right of the row 
-             being passed.
+    PURPOSE: To ask a running server to stop
 
+    INPUTS: The number of the signal received.
 
-    ALGORITHM(S): This function is a combination of the logic contained within
-                  both B() and R() functions. Essentially, You are shifting
-                  the lower row to the left and bitwise AND-ing it with the
-                  upper row.
-
-                  For the ZOMBIE condition you are negating the
-                  upper row to flip the cells from dead to alive temporarily
-                  and bitwise ANDing it with the shifted row.
-
-                  The result of this is being returned.
-
+    OUTPUTS: NONE
 
 *******************************************************************************/
 
-uLLInt BR(int row, int condition) {
-    // upper and lower rows being compared
-    int upper, lower;
-
-    // set upper to the row being passed
-    upper = row;
-
-    // set lower to the row below the one being passed
-    lower = row + 1;
-
-    // wrap the lower row around if it goes beyond the bottom of the grid
-    lower %= SIZE;
-
-    // the row being shifted
-    uLLInt shifted_row = grid[lower];
-
-    if (condition == NORMAL) {
-        // check for a bit that needs to be wrapped around
-        if (grid[lower] & LMASK) {
-            // shift the row by 1
-            shifted_row = ((shifted_row << 1) | RMASK);
-            // check if there is a left neighbour after shifting it over
-            return (grid[upper] & shifted_row);
-        } else {
-            return (grid[upper] & (shifted_row << 1));
-        }
-        
-    }
-
-    if (condition == ZOMBIE) {
-        // check for a bit that needs to be wrapped around
-        if (grid[lower] & LMASK) {
-            // shift the upper by 1 and set the right most bit
-            shifted_row = (shifted_row << 1) | RMASK;
-            // check if there is a left neighbour after shifting it over
-            return (~grid[upper]) & shifted_row;
-        } else {
-            return (~grid[upper]) & (shifted_row << 1);
-        }
-    }
-
+void onSignal(int signal_number) {
+    (void)signal_number;
+    interrupted = 1;
 }
-
@@ -0,0 +1,1220 @@
+/*******************************************************************************
+
+    PURPOSE: The Game of Life engine. Holds a board of cells inside a GolBoard
+             context and computes its generations based on the implementation
+             of the rules.
+
+    HISTORY: Created by Joseph Santoyo, March 6, 2015 (as part of gol.c),
+             split out into a library from gol.c.
+
+    INPUTS: A GolBoard created by golCreate().
+
+    OUTPUTS: The generations of the board, read back with golReadRegion().
+
+    ALGORITHM(S): The engine retrieves the next generation by calling a
+                  sumNeighbours() function twice for every word of every row.
+                  One for the NORMAL condition, and again for the ZOMBIE
+                  condition, bitwise OR-ing the return values in order to
+                  bring back to life the zombie cells, storing the results in
+                  the board's next_generation buffer.
+
+                  The next_generation buffer then becomes the board's grid,
+                  and the old grid is reused as the next_generation buffer of
+                  the following step.
+
+                  A board created with worker threads splits its rows into
+                  one band per thread. The workers live as long as the board.
+                  Each one first touches the pages of its band when the board
+                  is created and steps the same band every generation. When
+                  the workers are pinned, each to its own CPU, every band on
+                  a NUMA machine lives on the node that uses it.
+
+    NOTES: Every function works on the board passed to it and nothing else,
+           there is no global or static state in this file.
+
+*******************************************************************************/
+
+/*******************************************************************************
+    Begin #include statements
+*******************************************************************************/
+
+
+// pthread_attr_setaffinity_np(), pthread barriers, the CPU_* macros and
+// RUSAGE_THREAD
+#define _GNU_SOURCE
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include "gol_engine.h"
+
+
+/*******************************************************************************
+    Begin #define statements
+*******************************************************************************/
+
+
+// LMASK checks the left-most bit RMASK checks the right-most bit
+#define LMASK 0x8000000000000000
+#define RMASK 0x0000000000000001
+
+// cell conditions
+#define NORMAL 0
+#define ZOMBIE 1
+
+// compass directions
+#define TOP          0
+#define BOTTOM       1
+#define LEFT         2
+#define RIGHT        3
+#define TOP_LEFT     4
+#define TOP_RIGHT    5
+#define BOTTOM_LEFT  6
+#define BOTTOM_RIGHT 7
+
+// number of compass directions
+#define DIRECTIONS   8
+
+
+/*******************************************************************************
+    Begin declarations
+*******************************************************************************/
+
+
+struct GolBoard {
+    // number of rows, and number of uLLInt words in each row
+    size_t rows;
+    size_t words;
+    // number of generations computed since the board was seeded
+    unsigned long long generation;
+    // playing grid, rows * words cells packed row after row
+    uLLInt *grid;
+    // next generation of cells, same layout as grid
+    uLLInt *next_generation;
+    // memory holding both grid and next_generation
+    GolStorage storage;
+    // worker threads and the band of rows each one owns, 0 for none
+    size_t threads;
+    pthread_t *workers;
+    struct Band *bands;
+    // work handed to every worker for the current round, NULL to exit
+    void (*task)(struct Band *);
+    // workers wait at start for a task, and at done once it is finished
+    pthread_barrier_t start;
+    pthread_barrier_t done;
+    // held while the workers are being started
+    pthread_mutex_t startup;
+};
+
+// rows of a board handled by one worker thread
+typedef struct Band {
+    GolBoard *board;
+    size_t first;
+    size_t end;
+    // page faults taken by the last touchBand() on this band
+    long minor_faults;
+    long major_faults;
+} Band;
+
+// directional function prototypes
+static uLLInt TL(const GolBoard *, size_t, size_t, int);
+static uLLInt T(const GolBoard *, size_t, size_t, int);
+static uLLInt TR(const GolBoard *, size_t, size_t, int);
+static uLLInt L(const GolBoard *, size_t, size_t, int);
+static uLLInt R(const GolBoard *, size_t, size_t, int);
+static uLLInt BL(const GolBoard *, size_t, size_t, int);
+static uLLInt B(const GolBoard *, size_t, size_t, int);
+static uLLInt BR(const GolBoard *, size_t, size_t, int);
+
+// checks the number of neighbours a cell has for each cell in a word
+static uLLInt sumNeighbours(const GolBoard *, size_t, size_t, int);
+
+// returns a random word drawn from a caller owned state
+static uLLInt init(uLLInt *);
+
+// starts and stops the worker threads of a board
+static void startWorkers(GolBoard *, const GolStorageOptions *);
+static void stopWorkers(GolBoard *);
+static void *workerMain(void *);
+
+// runs a task over every band of the board
+static void runBands(GolBoard *, void (*)(Band *));
+static void touchBand(Band *);
+static void stepBand(Band *);
+
+
+/*******************************************************************************
+
+    PURPOSE: To create an empty board
+
+    HISTORY: Split out of gol.c's global grid[] and next_generation[] arrays
+
+    INPUTS: The number of rows and columns of the board, both size_t.
+
+    OUTPUTS: A pointer to the new board, or NULL if the dimensions are invalid
+             or the memory could not be allocated.
+
+    ALGORITHM(S): Same as golCreateWith() on the heap without worker threads.
+
+*******************************************************************************/
+
+GolBoard *golCreate(size_t rows, size_t columns) {
+    return golCreateWith(rows, columns, NULL);
+}
+
+/*******************************************************************************
+
+    PURPOSE: To create an empty board in a chosen kind of storage
+
+    INPUTS: The number of rows and columns of the board, and the storage
+            options (gol_storage.h), or NULL for the heap and no threads.
+
+    OUTPUTS: A pointer to the new board, or NULL if the dimensions are invalid
+             or the memory could not be allocated.
+
+    ALGORITHM(S): Check that the columns fill a whole number of uLLInt words.
+                  Allocate the context, then one block of storage holding
+                  the grid followed by the next_generation buffer.
+
+                  Start the worker threads with startWorkers(). Unless the
+                  board is backed by a file, have each
+                  worker first touch the pages of its band, so they are
+                  placed on its NUMA node. A file backed board may not fit in
+                  RAM, so its pages are left to be faulted in by the workers
+                  as they step. The first touch is part of the allocation
+                  report, adding up the faults of the calling thread and of
+                  each worker, and of no other thread.
+
+*******************************************************************************/
+
+GolBoard *golCreateWith(size_t rows, size_t columns,
+                        const GolStorageOptions *options) {
+    if (rows == 0 || columns == 0 || columns % GOL_WORD_BITS != 0) {
+        return NULL;
+    }
+
+    size_t words = columns / GOL_WORD_BITS;
+    if (rows > (size_t)-1 / 2 / sizeof(uLLInt) / words) {
+        return NULL;
+    }
+
+    GolBoard *board = calloc(1, sizeof(*board));
+    if (board == NULL) {
+        return NULL;
+    }
+
+    board->rows = rows;
+    board->words = words;
+
+    if (golStorageAlloc(&board->storage, options,
+                        2 * rows * words * sizeof(uLLInt)) != GOL_SUCCESS) {
+        golDestroy(board);
+        return NULL;
+    }
+    board->grid = board->storage.base;
+    board->next_generation = board->grid + rows * words;
+
+    if (options != NULL) {
+        startWorkers(board, options);
+    }
+
+    if (board->storage.report.kind != GOL_STORAGE_FILE) {
+        golStorageMeasureBegin(&board->storage.report);
+        runBands(board, touchBand);
+        golStorageMeasureEnd(&board->storage.report);
+
+        // the calling thread does not see the faults taken by the workers
+        size_t i;
+        for (i = 0; i < board->threads; i++) {
+            board->storage.report.minor_faults += board->bands[i].minor_faults;
+            board->storage.report.major_faults += board->bands[i].major_faults;
+        }
+    }
+
+    return board;
+}
+
+/*******************************************************************************
+
+    PURPOSE: To release a board
+
+    INPUTS: A board created by golCreate(), or NULL.
+
+    OUTPUTS: NONE
+
+*******************************************************************************/
+
+void golDestroy(GolBoard *board) {
+    if (board == NULL) {
+        return;
+    }
+
+    stopWorkers(board);
+    golStorageFree(&board->storage);
+    free(board);
+}
+
+/*******************************************************************************
+
+    PURPOSE: To initialize the board with random cells
+
+    HISTORY: Created by Joseph Santoyo, March 6, 2015 (as the loop in main())
+
+    INPUTS: A board and a seed.
+
+    OUTPUTS: NONE
+
+    ALGORITHM(S): Loops through each word of each row calling init() which
+                  returns a random word. The random state is a local variable
+                  so that seeding one board never disturbs another. The same
+                  seed always produces the same board.
+
+*******************************************************************************/
+
+void golSeed(GolBoard *board, unsigned long long seed) {
+    uLLInt state = seed;
+    size_t i;
+
+    for (i = 0; i < board->rows * board->words; i++) {
+        board->grid[i] = init(&state);
+    }
+    board->generation = 0;
+}
+
+/*******************************************************************************
+
+    PURPOSE: To advance the board by a number of generations
+
+    HISTORY: Created by Joseph Santoyo, March 6, 2015 (as the loop in main())
+
+    INPUTS: A board and the number of generations to compute.
+
+    OUTPUTS: NONE
+
+    ALGORITHM(S): Have every band of the board computed into next_generation
+                  with stepBand(), in parallel on a board with worker
+                  threads. Then swap the grid and next_generation buffers
+                  instead of copying the new generation over the old one.
+
+*******************************************************************************/
+
+void golStep(GolBoard *board, unsigned long long generations) {
+    while (generations-- > 0) {
+        // get the next generation
+        runBands(board, stepBand);
+
+        // replace the current generation with the next generation
+        uLLInt *old_generation = board->grid;
+        board->grid = board->next_generation;
+        board->next_generation = old_generation;
+
+        board->generation++;
+    }
+}
+
+/*******************************************************************************
+
+    PURPOSE: To start the worker threads of a board
+
+    INPUTS: A board and the options giving the number of worker threads
+            wanted and whether and where to pin them.
+
+    OUTPUTS: NONE, board->threads is left at the number of workers running,
+             or 0 if the board is stepped by the calling thread.
+
+    ALGORITHM(S): Cap the number of workers at the number of CPUs the process
+                  may run on and at the number of rows. Start one thread per
+                  band while holding the startup mutex. When pinning, worker
+                  i gets allowed CPU first_cpu + i, counting only the CPUs
+                  the process may run on and wrapping around. If a thread can
+                  not be started, carry on with the ones that were. Only then
+                  are the bands laid out and the barriers sized for the
+                  workers plus the caller, and the mutex released so the
+                  workers can go and wait at the start barrier.
+
+*******************************************************************************/
+
+static void startWorkers(GolBoard *board, const GolStorageOptions *options) {
+    cpu_set_t allowed;
+    int known = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+    long cpus = known ? CPU_COUNT(&allowed) : sysconf(_SC_NPROCESSORS_ONLN);
+    int pinned = known && options->pin;
+    size_t wanted = options->threads;
+    size_t i;
+
+    if (cpus > 0 && wanted > (size_t)cpus) {
+        wanted = cpus;
+    }
+    if (wanted > board->rows) {
+        wanted = board->rows;
+    }
+    if (wanted < 2) {
+        return;
+    }
+
+    board->workers = malloc(wanted * sizeof(pthread_t));
+    board->bands = malloc(wanted * sizeof(Band));
+    if (board->workers == NULL || board->bands == NULL) {
+        free(board->workers);
+        free(board->bands);
+        board->workers = NULL;
+        board->bands = NULL;
+        return;
+    }
+
+    for (i = 0; i < wanted; i++) {
+        board->bands[i].board = board;
+    }
+    pthread_mutex_init(&board->startup, NULL);
+    pthread_mutex_lock(&board->startup);
+
+    for (i = 0; i < wanted; i++) {
+        pthread_attr_t attributes;
+
+        pthread_attr_init(&attributes);
+        if (pinned) {
+            // find the allowed CPU this worker gets
+            size_t skip = (options->first_cpu + i) % cpus;
+            int cpu = 0;
+            while (!CPU_ISSET(cpu, &allowed) || skip-- > 0) {
+                cpu++;
+            }
+            cpu_set_t own;
+            CPU_ZERO(&own);
+            CPU_SET(cpu, &own);
+            pthread_attr_setaffinity_np(&attributes, sizeof(own), &own);
+        }
+        int started = pthread_create(&board->workers[i], &attributes,
+                                     workerMain, &board->bands[i]) == 0;
+        pthread_attr_destroy(&attributes);
+
+        if (!started) {
+            break;
+        }
+    }
+
+    board->threads = i;
+    for (i = 0; i < board->threads; i++) {
+        board->bands[i].first = i * board->rows / board->threads;
+        board->bands[i].end = (i + 1) * board->rows / board->threads;
+    }
+    if (board->threads > 0) {
+        pthread_barrier_init(&board->start, NULL, board->threads + 1);
+        pthread_barrier_init(&board->done, NULL, board->threads + 1);
+    }
+
+    pthread_mutex_unlock(&board->startup);
+
+    if (board->threads == 0) {
+        pthread_mutex_destroy(&board->startup);
+        free(board->workers);
+        free(board->bands);
+        board->workers = NULL;
+        board->bands = NULL;
+    }
+}
+
+/*******************************************************************************
+
+    PURPOSE: To stop the worker threads of a board
+
+    INPUTS: A board.
+
+    OUTPUTS: NONE
+
+    ALGORITHM(S): Hand the workers an empty task, which makes them return,
+                  and wait for all of them.
+
+*******************************************************************************/
+
+static void stopWorkers(GolBoard *board) {
+    size_t i;
+
+    if (board->threads == 0) {
+        return;
+    }
+
+    board->task = NULL;
+    pthread_barrier_wait(&board->start);
+    for (i = 0; i < board->threads; i++) {
+        pthread_join(board->workers[i], NULL);
+    }
+
+    pthread_barrier_destroy(&board->start);
+    pthread_barrier_destroy(&board->done);
+    pthread_mutex_destroy(&board->startup);
+    free(board->workers);
+    free(board->bands);
+    board->threads = 0;
+}
+
+/*******************************************************************************
+
+    PURPOSE: To run the body of a worker thread
+
+    INPUTS: The worker's Band.
+
+    OUTPUTS: NULL
+
+    ALGORITHM(S): Wait for startWorkers() to finish, then loop: wait at the
+                  start barrier, run the task on the worker's own band and
+                  meet the caller at the done barrier. The barriers also
+                  make the caller's writes visible to the workers and the
+                  workers' writes visible to the caller.
+
+*******************************************************************************/
+
+static void *workerMain(void *argument) {
+    Band *band = argument;
+    GolBoard *board = band->board;
+
+    pthread_mutex_lock(&board->startup);
+    pthread_mutex_unlock(&board->startup);
+
+    while (1) {
+        pthread_barrier_wait(&board->start);
+        if (board->task == NULL) {
+            break;
+        }
+        board->task(band);
+        pthread_barrier_wait(&board->done);
+    }
+
+    return NULL;
+}
+
+/*******************************************************************************
+
+    PURPOSE: To run a task over every band of the board
+
+    INPUTS: A board and a task taking a Band.
+
+    OUTPUTS: NONE
+
+    ALGORITHM(S): Without worker threads, run the task on the whole board.
+                  Otherwise hand it to the workers through the start barrier
+                  and wait at the done barrier until every band is finished.
+
+*******************************************************************************/
+
+static void runBands(GolBoard *board, void (*task)(Band *)) {
+    if (board->threads == 0) {
+        Band whole = {board, 0, board->rows, 0, 0};
+        task(&whole);
+        return;
+    }
+
+    board->task = task;
+    pthread_barrier_wait(&board->start);
+    pthread_barrier_wait(&board->done);
+}
+
+/*******************************************************************************
+
+    PURPOSE: To fault in the pages of a band from the thread that owns it
+
+    INPUTS: A Band.
+
+    OUTPUTS: NONE, the faults taken by this thread are left in the Band.
+
+    ALGORITHM(S): Write a zero into every page of the band in both buffers.
+                  The memory is already zero, only the page fault matters.
+
+*******************************************************************************/
+
+static void touchBand(Band *band) {
+    GolBoard *board = band->board;
+    size_t page = sysconf(_SC_PAGESIZE);
+    size_t first = band->first * board->words * sizeof(uLLInt);
+    size_t end = band->end * board->words * sizeof(uLLInt);
+    size_t offset;
+    struct rusage before, after;
+
+    getrusage(RUSAGE_THREAD, &before);
+    for (offset = first; offset < end; offset += page) {
+        ((volatile char *)board->grid)[offset] = 0;
+        ((volatile char *)board->next_generation)[offset] = 0;
+    }
+    getrusage(RUSAGE_THREAD, &after);
+
+    band->minor_faults = after.ru_minflt - before.ru_minflt;
+    band->major_faults = after.ru_majflt - before.ru_majflt;
+}
+
+/*******************************************************************************
+
+    PURPOSE: To compute the next generation of a band of rows
+
+    INPUTS: A Band.
+
+    OUTPUTS: NONE
+
+    ALGORITHM(S): For every word of every row in the band, bitwise OR the
+                  NORMAL and ZOMBIE results of sumNeighbours() into
+                  next_generation. Bands only write their own rows, so they
+                  never get in each other's way.
+
+*******************************************************************************/
+
+static void stepBand(Band *band) {
+    GolBoard *board = band->board;
+    size_t row, word;
+
+    for (row = band->first; row < band->end; row++) {
+        for (word = 0; word < board->words; word++) {
+            board->next_generation[row * board->words + word] =
+                (sumNeighbours(board, row, word, NORMAL) |
+                 sumNeighbours(board, row, word, ZOMBIE));
+        }
+    }
+}
+
+/*******************************************************************************
+
+    PURPOSE: To copy part of the current generation out of the board
+
+    INPUTS: A board, the first row and number of rows, the first word and
+            number of words of each row, and an output buffer.
+
+    OUTPUTS: GOL_SUCCESS, or GOL_FAILURE if the region does not fit on the
+             board. out receives row_count * word_count words, row after row.
+
+*******************************************************************************/
+
+int golReadRegion(const GolBoard *board, size_t first_row, size_t row_count,
+                  size_t first_word, size_t word_count, uLLInt *out) {
+    if (first_row > board->rows || row_count > board->rows - first_row ||
+        first_word > board->words || word_count > board->words - first_word) {
+        return GOL_FAILURE;
+    }
+
+    size_t row;
+    for (row = 0; row < row_count; row++) {
+        memcpy(out + row * word_count,
+               board->grid + (first_row + row) * board->words + first_word,
+               word_count * sizeof(uLLInt));
+    }
+
+    return GOL_SUCCESS;
+}
+
+/*******************************************************************************
+
+    PURPOSE: To overwrite part of the current generation of the board
+
+    INPUTS: A board, the first row and number of rows, the first word and
+            number of words of each row, and an input buffer holding
+            row_count * word_count words, row after row.
+
+    OUTPUTS: GOL_SUCCESS, or GOL_FAILURE if the region does not fit on the
+             board. The generation counter is left unchanged.
+
+*******************************************************************************/
+
+int golLoadRegion(GolBoard *board, size_t first_row, size_t row_count,
+                  size_t first_word, size_t word_count, const uLLInt *in) {
+    if (first_row > board->rows || row_count > board->rows - first_row ||
+        first_word > board->words || word_count > board->words - first_word) {
+        return GOL_FAILURE;
+    }
+
+    size_t row;
+    for (row = 0; row < row_count; row++) {
+        memcpy(board->grid + (first_row + row) * board->words + first_word,
+               in + row * word_count,
+               word_count * sizeof(uLLInt));
+    }
+
+    return GOL_SUCCESS;
+}
+
+/*******************************************************************************
+
+    PURPOSE: To put the board back to a generation saved earlier
+
+    INPUTS: A board, rows * words cells packed row after row, and the number
+            of the generation they were saved from.
+
+    OUTPUTS: NONE
+
+*******************************************************************************/
+
+void golRestore(GolBoard *board, const uLLInt *cells,
+                unsigned long long generation) {
+    memcpy(board->grid, cells, board->rows * board->words * sizeof(uLLInt));
+    board->generation = generation;
+}
+
+/*******************************************************************************
+
+    PURPOSE: To read the current generation in place
+
+    INPUTS: A board.
+
+    OUTPUTS: A pointer to rows * words cells packed row after row. The grid and
+             next_generation buffers swap on every step, so the pointer is
+             only good until the next golStep() or golDestroy().
+
+*******************************************************************************/
+
+const uLLInt *golCells(const GolBoard *board) {
+    return board->grid;
+}
+
+const GolStorageReport *golAllocationReport(const GolBoard *board) {
+    return &board->storage.report;
+}
+
+size_t golRows(const GolBoard *board) {
+    return board->rows;
+}
+
+size_t golWords(const GolBoard *board) {
+    return board->words;
+}
+
+unsigned long long golGeneration(const GolBoard *board) {
+    return board->generation;
+}
+
+/*******************************************************************************
+
+    PURPOSE: To return a randomized word
+
+    HISTORY: Created by D. Houtman, Modified to use a caller owned state in
+             place of rand() so that seeding is reentrant.
+
+    INPUTS: A pointer to the random state, updated on every call.
+
+    OUTPUTS: A random 64-bit uLLInt
+
+    ALGORITHM(S): splitmix64. Advance the state by a fixed odd constant, then
+                  mix its bits with two multiply and xor-shift rounds.
+
+*******************************************************************************/
+
+static uLLInt init(uLLInt *state) {
+    uLLInt init64;
+
+    init64 = (*state += 0x9E3779B97F4A7C15);
+    init64 = (init64 ^ (init64 >> 30)) * 0xBF58476D1CE4E5B9;
+    init64 = (init64 ^ (init64 >> 27)) * 0x94D049BB133111EB;
+
+    return init64 ^ (init64 >> 31);
+}
+
+/*******************************************************************************
+
+    PURPOSE: To return a word of the current generation
+
+    INPUTS: A board, a row number and a word number.
+
+    OUTPUTS: The uLLInt holding those cells
+
+*******************************************************************************/
+
+static uLLInt cell(const GolBoard *board, size_t row, size_t word) {
+    return board->grid[row * board->words + word];
+}
+
+/*******************************************************************************
+
+    PURPOSE: To count the number of neighbours surrounding a cell
+
+    HISTORY: Created by D. Houtman, Modified by Joseph Santoyo, March 6, 2015
+
+    INPUTS: A board, a row number, a word number within the row and an int
+            condition (NORMAL OR ZOMBIE)
+
+    OUTPUTS: An uLLInt next_generation which represents the next generation of
+             the word being passed in.
+
+    ALGORITHM(S): Initialize an array which represents the neighbours surroundi-
+                  ng a cell. For each of the 8 directional positions around a
+                  cell, call the functions corresponding to those positions.
+
+                  Set a mask corresponding to a left bit-mask, initialize a
+                  uLLInt next_generation to 0.
+
+                  While the mask has not shifted off the end, iterate through
+                  each of the 8 directional positions and sum up all the 1's
+                  in the column of wherever the mask is currently positioned,
+                  store the total in total_alive_neighbours.
+
+                  If the condition provided is NORMAL and the number of alive
+                  neighbours is either 2 or 3, keep that cell alive.
+
+                  If the condition is ZOMBIE and the number of total alive neigh
+                  bours is 3, revive the zombie cell.
+
+                  Shift the mask of a column and repeat if the mask has not
+                  shifted off the end.
+
+*******************************************************************************/
+
+static uLLInt sumNeighbours(const GolBoard *board, size_t row, size_t word,
+                            int condition) {
+    uLLInt neighbours[DIRECTIONS] = {0};
+
+    neighbours[TOP] = T(board, row, word, condition);
+    neighbours[RIGHT] = R(board, row, word, condition);
+    neighbours[BOTTOM] = B(board, row, word, condition);
+    neighbours[LEFT] = L(board, row, word, condition);
+    neighbours[TOP_RIGHT] = TR(board, row, word, condition);
+    neighbours[TOP_LEFT] = TL(board, row, word, condition);
+    neighbours[BOTTOM_LEFT] = BL(board, row, word, condition);
+    neighbours[BOTTOM_RIGHT] = BR(board, row, word, condition);
+
+    uLLInt MASK = LMASK;
+    uLLInt next_generation = 0;
+    while (MASK) {
+        int total_alive_neighbours = 0;
+
+        for (unsigned int compass = 0; compass < DIRECTIONS; compass++) {
+            total_alive_neighbours += ((MASK & neighbours[compass]) > 0);
+        }
+
+        if ((condition == NORMAL) &&
+            (total_alive_neighbours == 2 || total_alive_neighbours == 3)) {
+            // keep that cell alive
+            next_generation |= MASK;
+        }
+        if ((condition == ZOMBIE) && total_alive_neighbours == 3) {
+            // revive the cell
+            next_generation |= MASK;
+        }
+
+        MASK >>= 1;
+    }
+
+    return next_generation;
+}
+
+/*******************************************************************************
+
+    PURPOSE: To shift a word one cell to the right, bringing in the right-most
+             cell of the word to its left.
+
+    INPUTS: A board, a row number and a word number.
+
+    OUTPUTS: A word whose cells are the left neighbours of the word passed in.
+
+    ALGORITHM(S): Shift the word right by 1. If the word to the left has a live
+                  cell on its right-most bit, set the left-most bit on. With a
+                  single word per row the word to the left is the word itself,
+                  which wraps the row's cells around.
+
+*******************************************************************************/
+
+static uLLInt shiftRight(const GolBoard *board, size_t row, size_t word) {
+    // the word to the left, wrapping around the left edge of the row
+    size_t left = (word + board->words - 1) % board->words;
+
+    // the row being shifted
+    uLLInt shifted_row = cell(board, row, word) >> 1;
+
+    // check for a bit that needs to be wrapped around
+    if (cell(board, row, left) & RMASK) {
+        shifted_row |= LMASK;
+    }
+
+    return shifted_row;
+}
+
+/*******************************************************************************
+
+    PURPOSE: To shift a word one cell to the left, bringing in the left-most
+             cell of the word to its right.
+
+    INPUTS: A board, a row number and a word number.
+
+    OUTPUTS: A word whose cells are the right neighbours of the word passed in.
+
+    ALGORITHM(S): Shift the word left by 1. If the word to the right has a live
+                  cell on its left-most bit, set the right-most bit on. With a
+                  single word per row the word to the right is the word itself,
+                  which wraps the row's cells around.
+
+*******************************************************************************/
+
+static uLLInt shiftLeft(const GolBoard *board, size_t row, size_t word) {
+    // the word to the right, wrapping around the right edge of the row
+    size_t right = (word + 1) % board->words;
+
+    // the row being shifted
+    uLLInt shifted_row = cell(board, row, word) << 1;
+
+    // check for a bit that needs to be wrapped around
+    if (cell(board, row, right) & LMASK) {
+        shifted_row |= RMASK;
+    }
+
+    return shifted_row;
+}
+
+/*******************************************************************************
+
+    PURPOSE: To find out how many alive cells a row of cells has above it
+
+    HISTORY: Created by Joseph Santoyo, March 6, 2015
+
+    INPUTS: A board, a row number, a word number and condition.
+
+    OUTPUTS: The uLLInt representing the alive cells above the word provided
+
+    ALGORITHM(S): Set upper to the row above the one being passed, adding the
+                  number of rows due to C's peculiar functionality with the %
+                  operator. Wrap the upper row around if it goes beyond the
+                  top of the grid.
+
+                  Set lower to the row being passed.
+
+                  If the condition is a NORMAL condition bit-wise and the upper
+                  row with the lower row and return the result.
+
+                  If the condition is a ZOMBIE condition bit-wise and the upper
+                  row with a negated lower row (effectively turning on the
+                  Zombie cells temporarily). Return that result.
+
+
+*******************************************************************************/
+
+static uLLInt T(const GolBoard *board, size_t row, size_t word,
+                int condition) {
+    // upper and lower rows being compared
+    size_t upper, lower;
+
+    // set upper to the row above the one being passed
+    upper = (row + board->rows - 1);
+    // wrap the upper row around if it goes beyond the top of the grid
+    upper %= board->rows;
+
+    // set lower to the row being passed
+    lower = row;
+
+    if (condition == NORMAL) {
+        return cell(board, upper, word) & cell(board, lower, word);
+    }
+
+    // make the dead cells alive and the alive cells dead so you can check
+    // whether or not zombie cells have any live neighbours above
+    return cell(board, upper, word) & (~cell(board, lower, word));
+}
+
+/*******************************************************************************
+
+    PURPOSE: To determine the live cells below a row being passed in.
+
+    HISTORY: Created by Joseph Santoyo, March 6, 2015
+
+    INPUTS: A board, a row number, a word number and condition.
+
+    OUTPUTS: A uLLInt representing the live cells below a word
+
+    ALGORITHM(S): Set upper to the row being passed and lower to the row below
+                  the one being passed. Wrap the lower row around if it goes
+                  beyond the bottom of the grid.
+
+                  If the condition is NORMAL bit-wise and the upper and lower
+                  rows. Return the result.
+
+                  If the condition is ZOMBIE, negate the upper row (temporarily
+                  turning on the zombie cells) and bit-wise and that with the
+                  lower row. Return the result.
+
+*******************************************************************************/
+
+static uLLInt B(const GolBoard *board, size_t row, size_t word,
+                int condition) {
+    // upper and lower rows being compared
+    size_t upper, lower;
+
+    // set upper to the row being passed
+    upper = row;
+
+    // set lower to the row below the one being passed
+    lower = row + 1;
+
+    // wrap the lower row around if it goes beyond the bottom of the grid
+    lower %= board->rows;
+
+    if (condition == NORMAL) {
+        return cell(board, upper, word) & cell(board, lower, word);
+    }
+
+    return (~cell(board, upper, word)) & cell(board, lower, word);
+}
+
+/*******************************************************************************
+
+    PURPOSE: To determine which cells left of the word being passed, are alive.
+
+    HISTORY: Created by Joseph Santoyo, March 6, 2015
+
+    INPUTS: A board, a row number, a word number and condition.
+
+    OUTPUTS: A word representing the live cells to the left of the word being
+             passed.
+
+    ALGORITHM(S): Shift the word to the right with shiftRight(), which wraps
+                  the cell coming in from the word to the left.
+
+                  If the condition is NORMAL, bit-wise AND this shifted row
+                  with the row you want to check. Return the result.
+
+                  The same will be done for zombie rows except you will be temp-
+                  orarily turning on the zombies in the row you are checking be-
+                  fore bit-wise ANDing the shifted row with the zombie row.
+
+*******************************************************************************/
+
+static uLLInt L(const GolBoard *board, size_t row, size_t word,
+                int condition) {
+    // the row being shifted
+    uLLInt shifted_row = shiftRight(board, row, word);
+
+    if (condition == NORMAL) {
+        // check if there is a left neighbour after shifting it over
+        return cell(board, row, word) & shifted_row;
+    }
+
+    return (~cell(board, row, word)) & shifted_row;
+}
+
+/*******************************************************************************
+
+    PURPOSE: To determine which cells right of the word being passed, are alive.
+
+    HISTORY: Created by Joseph Santoyo, March 6, 2015
+
+    INPUTS: A board, a row number, a word number and condition.
+
+    OUTPUTS: A word representing the live cells to the right of the word being
+             passed.
+
+    ALGORITHM(S): Shift the word to the left with shiftLeft(), which wraps
+                  the cell coming in from the word to the right.
+
+                  If the condition is NORMAL, bit-wise AND this shifted row
+                  with the row you want to check. Return the result.
+
+                  The same will be done for zombie rows except you will be temp-
+                  orarily turning on the zombies in the row you are checking be-
+                  fore bit-wise ANDing the shifted row with the zombie row.
+
+
+*******************************************************************************/
+
+static uLLInt R(const GolBoard *board, size_t row, size_t word,
+                int condition) {
+    // the row being shifted
+    uLLInt shifted_row = shiftLeft(board, row, word);
+
+    if (condition == NORMAL) {
+        // check if there is a right neighbour after shifting it over
+        return cell(board, row, word) & shifted_row;
+    }
+
+    return (~cell(board, row, word)) & shifted_row;
+}
+
+/*******************************************************************************
+
+    PURPOSE: To determine which cells in the word being passed have live cells
+             to their top left.
+
+    HISTORY: Created by Joseph Santoyo, March 6, 2015
+
+    INPUTS: A board, a row number, a word number and condition.
+
+    OUTPUTS: A word representing the live cells to the top left of the word
+             being passed.
+
+    ALGORITHM(S): This function is a combination of the logic contained within
+                  both T() and L() functions. Essentially, You are shifting
+                  the upper row to the right and bitwise AND-ing it with the
+                  lower row.
+
+                  For the ZOMBIE condition you are negating the
+                  lower row to flip the cells from dead to alive temporarily
+                  and bitwise ANDing it with the shifted row.
+
+                  The result of this is being returned.
+
+*******************************************************************************/
+
+static uLLInt TL(const GolBoard *board, size_t row, size_t word,
+                 int condition) {
+    // upper and lower rows being compared
+    size_t upper, lower;
+
+    // set upper to the row above the one being passed
+    upper = row + board->rows - 1;
+    // wrap the upper row around if it goes beyond the top of the grid
+    upper %= board->rows;
+
+    // set lower to the row being passed
+    lower = row;
+
+    // the row being shifted
+    uLLInt shifted_row = shiftRight(board, upper, word);
+
+    if (condition == NORMAL) {
+        return cell(board, lower, word) & shifted_row;
+    }
+
+    return (~cell(board, lower, word)) & shifted_row;
+}
+
+/*******************************************************************************
+
+    PURPOSE: To determine which cells in the word being passed have live cells
+             to their top right.
+
+    HISTORY: Created by Joseph Santoyo, March 6, 2015
+
+    INPUTS: A board, a row number, a word number and condition.
+
+    OUTPUTS: A word representing the live cells to the top right of the word
+             being passed.
+
+    ALGORITHM(S): This function is a combination of the logic contained within
+                  both T() and R() functions. Essentially, You are shifting
+                  the upper row to the left and bitwise AND-ing it with the
+                  lower row.
+
+                  For the ZOMBIE condition you are negating the
+                  lower row to flip the cells from dead to alive temporarily
+                  and bitwise ANDing it with the shifted row.
+
+                  The result of this is being returned.
+
+*******************************************************************************/
+
+static uLLInt TR(const GolBoard *board, size_t row, size_t word,
+                 int condition) {
+    // upper and lower rows being compared
+    size_t upper, lower;
+
+    // set upper to the row above the one being passed
+    upper = row + board->rows - 1;
+    // wrap the upper row around if it goes beyond the top of the grid
+    upper %= board->rows;
+
+    // set lower to the row being passed
+    lower = row;
+
+    // the row being shifted
+    uLLInt shifted_row = shiftLeft(board, upper, word);
+
+    if (condition == NORMAL) {
+        return cell(board, lower, word) & shifted_row;
+    }
+
+    return (~cell(board, lower, word)) & shifted_row;
+}
+
+/*******************************************************************************
+
+    PURPOSE: To determine which cells in the word being passed have live cells
+             to their bottom left.
+
+    HISTORY: Created by Joseph Santoyo, March 6, 2015
+
+    INPUTS: A board, a row number, a word number and condition.
+
+    OUTPUTS: A word representing the live cells to the bottom left of the word
+             being passed.
+
+    ALGORITHM(S): This function is a combination of the logic contained within
+                  both B() and L() functions. Essentially, You are shifting
+                  the lower row to the right and bitwise AND-ing it with the
+                  upper row.
+
+                  For the ZOMBIE condition you are negating the
+                  upper row to flip the cells from dead to alive temporarily
+                  and bitwise ANDing it with the shifted row.
+
+                  The result of this is being returned.
+
+
+*******************************************************************************/
+
+static uLLInt BL(const GolBoard *board, size_t row, size_t word,
+                 int condition) {
+    // upper and lower rows being compared
+    size_t upper, lower;
+
+    // set upper to the row being passed
+    upper = row;
+
+    // set lower to the row below the one being passed
+    lower = row + 1;
+
+    // wrap the lower row around if it goes beyond the bottom of the grid
+    lower %= board->rows;
+
+    // the row being shifted
+    uLLInt shifted_row = shiftRight(board, lower, word);
+
+    if (condition == NORMAL) {
+        return cell(board, upper, word) & shifted_row;
+    }
+
+    return (~cell(board, upper, word)) & shifted_row;
+}
+
+/*******************************************************************************
+
+    PURPOSE: To determine which cells in the word being passed have live cells
+             to their bottom right.
+
+    HISTORY: Created by Joseph Santoyo, March 6, 2015
+
+    INPUTS: A board, a row number, a word number and condition.
+
+    OUTPUTS: A word representing the live cells to the bottom right of the word
+             being passed.
+
+
+    ALGORITHM(S): This function is a combination of the logic contained within
+                  both B() and R() functions. Essentially, You are shifting
+                  the lower row to the left and bitwise AND-ing it with the
+                  upper row.
+
+                  For the ZOMBIE condition you are negating the
+                  upper row to flip the cells from dead to alive temporarily
+                  and bitwise ANDing it with the shifted row.
+
+                  The result of this is being returned.
+
+
+*******************************************************************************/
+
+static uLLInt BR(const GolBoard *board, size_t row, size_t word,
+                 int condition) {
+    // upper and lower rows being compared
+    size_t upper, lower;
+
+    // set upper to the row being passed
+    upper = row;
+
+    // set lower to the row below the one being passed
+    lower = row + 1;
+
+    // wrap the lower row around if it goes beyond the bottom of the grid
+    lower %= board->rows;
+
+    // the row being shifted
+    uLLInt shifted_row = shiftLeft(board, lower, word);
+
+    if (condition == NORMAL) {
+        return cell(board, upper, word) & shifted_row;
+    }
+
+    return (~cell(board, upper, word)) & shifted_row;
+}
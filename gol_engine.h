@@ -0,0 +1,108 @@
+/*******************************************************************************
+
+    PURPOSE: Public interface of the Game of Life engine library. Every board
+             lives in its own opaque GolBoard context so that one process can
+             run any number of independent simulations, on any number of
+             threads, without sharing state between them.
+
+    HISTORY: Created by Joseph Santoyo, March 6, 2015 (as part of gol.c),
+             split out into a library from gol.c.
+
+    BUILD: "make" builds libgol.a, libgol.so and the gol program (see the
+           Makefile). The library holds the engine together with the
+           storage, history, viewport, shared-memory ring and server
+           modules. Programs link it with -pthread, and with -lrt for
+           shm_open() on older C libraries:
+
+               cc -o program program.c -L. -lgol -lrt -pthread
+
+    NOTES: The library keeps no global or static state. Two different boards
+           can be used from two different threads at the same time without
+           any locking. A single board is not synchronized, so callers that
+           share one board between threads must serialize access to it.
+
+           Each row of a board is packed into uLLInt words, 64 cells per word,
+           with the left-most cell of a word stored in its left-most bit
+           (LMASK). The board wraps around on all four edges.
+
+*******************************************************************************/
+
+#ifndef GOL_ENGINE_H
+#define GOL_ENGINE_H
+
+
+/*******************************************************************************
+    Begin #include statements
+*******************************************************************************/
+
+
+#include <stddef.h>
+
+#include "gol_storage.h"
+
+
+/*******************************************************************************
+    Begin #define statements
+*******************************************************************************/
+
+
+// return values of the engine functions
+#define GOL_SUCCESS  0
+#define GOL_FAILURE -1
+
+// number of cells packed into each uLLInt word of a row
+#define GOL_WORD_BITS 64
+
+
+/*******************************************************************************
+    Begin declarations
+*******************************************************************************/
+
+
+// data type used for the cells to create 64 cells per row
+typedef unsigned long long int uLLInt;
+
+// opaque context holding everything that belongs to a single board
+typedef struct GolBoard GolBoard;
+
+// creates an empty board, columns must be a multiple of GOL_WORD_BITS
+GolBoard *golCreate(size_t rows, size_t columns);
+
+// creates an empty board in the given storage, stepped by worker threads
+GolBoard *golCreateWith(size_t rows, size_t columns,
+                        const GolStorageOptions *options);
+
+// releases a board and everything it owns
+void golDestroy(GolBoard *board);
+
+// fills the board with random cells derived from seed
+void golSeed(GolBoard *board, unsigned long long seed);
+
+// advances the board by the given number of generations
+void golStep(GolBoard *board, unsigned long long generations);
+
+// copies a rectangle of packed row words out of the current generation
+int golReadRegion(const GolBoard *board, size_t first_row, size_t row_count,
+                  size_t first_word, size_t word_count, uLLInt *out);
+
+// copies a rectangle of packed row words into the current generation
+int golLoadRegion(GolBoard *board, size_t first_row, size_t row_count,
+                  size_t first_word, size_t word_count, const uLLInt *in);
+
+// replaces the whole board with cells saved from the given generation
+void golRestore(GolBoard *board, const uLLInt *cells,
+                unsigned long long generation);
+
+// read-only view of the current generation, valid until the next golStep()
+const uLLInt *golCells(const GolBoard *board);
+
+// time and page faults taken to allocate the board's memory
+const GolStorageReport *golAllocationReport(const GolBoard *board);
+
+// dimensions and generation counter of a board
+size_t golRows(const GolBoard *board);
+size_t golWords(const GolBoard *board);
+unsigned long long golGeneration(const GolBoard *board);
+
+
+#endif
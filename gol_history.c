@@ -0,0 +1,416 @@
+/*******************************************************************************
+
+    PURPOSE: Implementation of the generation history declared in
+             gol_history.h.
+
+    HISTORY: Created for rewinding and replaying runs.
+
+    NOTES: The data of an entry is a list of runs. Each run is its starting
+           word index, its number of words, and that many XOR words:
+
+               start, count, xor[0], ..., xor[count - 1], start, count, ...
+
+           Applying a run XORs its words into the board at start, which turns
+           the previous generation into the entry's generation. A keyframe is
+           applied to an empty board.
+
+*******************************************************************************/
+
+/*******************************************************************************
+    Begin #include statements
+*******************************************************************************/
+
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "gol_history.h"
+
+
+/*******************************************************************************
+    Begin declarations
+*******************************************************************************/
+
+
+typedef struct {
+    unsigned long long generation;
+    // true if data is relative to an empty board
+    int keyframe;
+    // number of uLLInts in data
+    size_t length;
+    uLLInt *data;
+} Entry;
+
+struct GolHistory {
+    // size of the board in rows and words per row
+    size_t rows;
+    size_t words;
+    // ring of entries in increasing generation order
+    Entry *entries;
+    size_t capacity;
+    size_t first;
+    size_t count;
+    // generations between keyframes, and deltas stored since the last one
+    size_t interval;
+    size_t since_keyframe;
+    // newest generation recorded, the base of the next delta, invalid once
+    // a record has failed after dropping entries
+    uLLInt *last;
+    int last_valid;
+    // generation rebuilt by the last seek, reused when seeking forward
+    uLLInt *cursor;
+    int cursor_valid;
+    unsigned long long cursor_generation;
+    // bytes held by the data of all entries
+    size_t bytes;
+};
+
+
+static Entry *entryAt(const GolHistory *history, size_t index) {
+    return &history->entries[(history->first + index) % history->capacity];
+}
+
+/*******************************************************************************
+
+    PURPOSE: To create a history store
+
+    INPUTS: The size of the board in rows and words, the most generations to
+            keep and the number of generations between keyframes.
+
+    OUTPUTS: The store, or NULL on failure.
+
+    ALGORITHM(S): The interval is capped at half the capacity, so a full store
+                  that drops its oldest keyframe group still keeps at least
+                  capacity - interval generations.
+
+*******************************************************************************/
+
+GolHistory *golHistoryCreate(size_t rows, size_t words, size_t capacity,
+                             size_t interval) {
+    if (rows == 0 || words == 0 || capacity == 0 || interval == 0) {
+        return NULL;
+    }
+
+    GolHistory *history = calloc(1, sizeof(*history));
+    if (history == NULL) {
+        return NULL;
+    }
+
+    history->rows = rows;
+    history->words = words;
+    history->capacity = capacity;
+    history->interval = interval < capacity / 2 ? interval : capacity / 2;
+    if (history->interval == 0) {
+        history->interval = 1;
+    }
+    history->entries = calloc(capacity, sizeof(Entry));
+    history->last = calloc(rows * words, sizeof(uLLInt));
+    history->cursor = calloc(rows * words, sizeof(uLLInt));
+
+    if (history->entries == NULL || history->last == NULL ||
+        history->cursor == NULL) {
+        golHistoryDestroy(history);
+        return NULL;
+    }
+
+    return history;
+}
+
+/*******************************************************************************
+
+    PURPOSE: To release a history store
+
+    INPUTS: A store from golHistoryCreate(), or NULL.
+
+    OUTPUTS: NONE
+
+*******************************************************************************/
+
+void golHistoryDestroy(GolHistory *history) {
+    if (history == NULL) {
+        return;
+    }
+
+    size_t i;
+    for (i = 0; history->entries != NULL && i < history->count; i++) {
+        free(entryAt(history, i)->data);
+    }
+    free(history->entries);
+    free(history->last);
+    free(history->cursor);
+    free(history);
+}
+
+/*******************************************************************************
+
+    PURPOSE: To encode a generation as runs of changed words
+
+    INPUTS: The cells of the generation, the cells it is relative to (NULL for
+            an empty board), the number of words and a pointer receiving the
+            length of the encoding.
+
+    OUTPUTS: The encoded runs, or NULL on failure. A generation identical to
+             its base encodes to no runs and a non-NULL empty buffer.
+
+    ALGORITHM(S): A first pass counts the runs of non-zero XOR words and the
+                  words in them, so the second pass can fill a buffer of the
+                  exact size.
+
+*******************************************************************************/
+
+static uLLInt *encode(const uLLInt *cells, const uLLInt *base, size_t count,
+                      size_t *length) {
+    size_t runs = 0, changed = 0, i;
+
+    for (i = 0; i < count; i++) {
+        if ((cells[i] ^ (base ? base[i] : 0)) != 0) {
+            changed++;
+            if (i == 0 || (cells[i - 1] ^ (base ? base[i - 1] : 0)) == 0) {
+                runs++;
+            }
+        }
+    }
+
+    *length = 2 * runs + changed;
+    uLLInt *data = malloc((*length > 0 ? *length : 1) * sizeof(uLLInt));
+    if (data == NULL) {
+        return NULL;
+    }
+
+    uLLInt *run = NULL;
+    size_t used = 0;
+    for (i = 0; i < count; i++) {
+        uLLInt difference = cells[i] ^ (base ? base[i] : 0);
+        if (difference == 0) {
+            run = NULL;
+            continue;
+        }
+        if (run == NULL) {
+            // start a new run at this word
+            run = &data[used];
+            run[0] = i;
+            run[1] = 0;
+            used += 2;
+        }
+        run[1]++;
+        data[used++] = difference;
+    }
+
+    return data;
+}
+
+/*******************************************************************************
+
+    PURPOSE: To apply an entry to a board
+
+    INPUTS: An entry and the cells of the generation before it, or of an empty
+            board for a keyframe.
+
+    OUTPUTS: NONE, the cells are updated to the entry's generation.
+
+*******************************************************************************/
+
+static void apply(const Entry *entry, uLLInt *cells) {
+    size_t used = 0;
+
+    while (used < entry->length) {
+        uLLInt start = entry->data[used];
+        uLLInt count = entry->data[used + 1];
+        uLLInt i;
+
+        for (i = 0; i < count; i++) {
+            cells[start + i] ^= entry->data[used + 2 + i];
+        }
+        used += 2 + count;
+    }
+}
+
+/*******************************************************************************
+
+    PURPOSE: To drop the newest or the oldest entry
+
+    INPUTS: The store.
+
+    OUTPUTS: NONE
+
+*******************************************************************************/
+
+static void dropNewest(GolHistory *history) {
+    Entry *entry = entryAt(history, history->count - 1);
+
+    history->bytes -= entry->length * sizeof(uLLInt);
+    free(entry->data);
+    entry->data = NULL;
+    history->count--;
+}
+
+static void dropOldest(GolHistory *history) {
+    Entry *entry = entryAt(history, 0);
+
+    history->bytes -= entry->length * sizeof(uLLInt);
+    free(entry->data);
+    entry->data = NULL;
+    history->first = (history->first + 1) % history->capacity;
+    history->count--;
+}
+
+/*******************************************************************************
+
+    PURPOSE: To add a generation to the store
+
+    INPUTS: The store, the cells of the generation and its number.
+
+    OUTPUTS: GOL_SUCCESS, or GOL_FAILURE if memory ran out, in which case
+             the generation is not stored and the next one recorded becomes
+             a keyframe.
+
+    ALGORITHM(S): A generation at or before the newest one stored means the
+                  board was reseeded, reloaded or rewound, so every entry from
+                  that generation on is dropped and the new entry becomes a
+                  keyframe, as the dropped ones no longer lead up to it.
+
+                  Otherwise the entry is a delta from the last generation
+                  recorded, unless interval entries have passed since the
+                  last keyframe or the store is empty.
+
+                  A full store first drops its oldest keyframe together with
+                  the deltas that follow it.
+
+*******************************************************************************/
+
+int golHistoryRecord(GolHistory *history, const uLLInt *cells,
+                     unsigned long long generation) {
+    size_t count = history->rows * history->words;
+    int keyframe = 0;
+
+    while (history->count > 0 &&
+           entryAt(history, history->count - 1)->generation >= generation) {
+        dropNewest(history);
+        history->cursor_valid = 0;
+        keyframe = 1;
+    }
+
+    if (history->count == history->capacity) {
+        do {
+            dropOldest(history);
+        } while (history->count > 0 && !entryAt(history, 0)->keyframe);
+        history->cursor_valid = 0;
+    }
+
+    if (history->count == 0 || !history->last_valid ||
+        history->since_keyframe + 1 >= history->interval) {
+        keyframe = 1;
+    }
+
+    Entry entry;
+    entry.generation = generation;
+    entry.keyframe = keyframe;
+    entry.data = encode(cells, keyframe ? NULL : history->last, count,
+                        &entry.length);
+    if (entry.data == NULL) {
+        // last may no longer be the newest entry, so it can not be the base
+        // of a delta or stand in for the newest generation
+        history->last_valid = 0;
+        return GOL_FAILURE;
+    }
+
+    *entryAt(history, history->count) = entry;
+    history->count++;
+    history->bytes += entry.length * sizeof(uLLInt);
+    history->since_keyframe = keyframe ? 0 : history->since_keyframe + 1;
+    memcpy(history->last, cells, count * sizeof(uLLInt));
+    history->last_valid = 1;
+
+    return GOL_SUCCESS;
+}
+
+/*******************************************************************************
+
+    PURPOSE: To rebuild a stored generation
+
+    INPUTS: The store and the generation wanted.
+
+    OUTPUTS: The cells of the generation, or NULL if it is not stored. The
+             cells belong to the store and change on the next call on it.
+
+    ALGORITHM(S): The newest generation is kept whole and returned as is,
+                  unless a failed record left it stale. Otherwise binary
+                  search the entries for the generation and walk back to its
+                  keyframe. If the last seek rebuilt a generation between
+                  that keyframe and the one wanted, carry on from there, so
+                  replaying forward costs one delta per generation. Otherwise
+                  start from the keyframe.
+
+*******************************************************************************/
+
+const uLLInt *golHistorySeek(GolHistory *history,
+                             unsigned long long generation) {
+    size_t low = 0, high = history->count;
+
+    if (history->count == 0) {
+        return NULL;
+    }
+    if (history->last_valid &&
+        entryAt(history, history->count - 1)->generation == generation) {
+        return history->last;
+    }
+
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (entryAt(history, middle)->generation < generation) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    if (low == history->count ||
+        entryAt(history, low)->generation != generation) {
+        return NULL;
+    }
+
+    size_t target = low;
+    size_t key = target;
+    while (!entryAt(history, key)->keyframe) {
+        key--;
+    }
+
+    size_t next = key;
+    if (history->cursor_valid &&
+        history->cursor_generation >= entryAt(history, key)->generation &&
+        history->cursor_generation <= generation) {
+        // the cursor is an entry between the keyframe and the target
+        while (entryAt(history, next)->generation !=
+               history->cursor_generation) {
+            next++;
+        }
+        next++;
+    } else {
+        memset(history->cursor, 0,
+               history->rows * history->words * sizeof(uLLInt));
+    }
+
+    for (; next <= target; next++) {
+        apply(entryAt(history, next), history->cursor);
+    }
+    history->cursor_valid = 1;
+    history->cursor_generation = generation;
+
+    return history->cursor;
+}
+
+unsigned long long golHistoryOldest(const GolHistory *history) {
+    return history->count > 0 ? entryAt(history, 0)->generation : 0;
+}
+
+unsigned long long golHistoryNewest(const GolHistory *history) {
+    return history->count > 0 ?
+           entryAt(history, history->count - 1)->generation : 0;
+}
+
+size_t golHistoryCount(const GolHistory *history) {
+    return history->count;
+}
+
+size_t golHistoryBytes(const GolHistory *history) {
+    return history->bytes;
+}
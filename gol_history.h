@@ -0,0 +1,70 @@
+/*******************************************************************************
+
+    PURPOSE: Bounded store of past generations of a board, so that a run can
+             be stepped backwards and replayed.
+
+    HISTORY: Created for rewinding and replaying runs.
+
+    ALGORITHM(S): Each recorded generation is kept as the XOR of its row words
+                  with the generation recorded before it. Only the words that
+                  changed are stored, as runs of consecutive changed words, so
+                  the memory used grows with the activity on the board and not
+                  with its size.
+
+                  Every interval generations a keyframe is stored instead: the
+                  XOR with an empty board, which keeps only the words holding
+                  live cells. Seeking to a generation starts from the keyframe
+                  at or before it and applies at most interval - 1 deltas.
+
+                  When the store is full, the oldest keyframe and the deltas
+                  that depend on it are dropped together. The interval is
+                  capped at half the capacity so that this never empties the
+                  store.
+
+*******************************************************************************/
+
+#ifndef GOL_HISTORY_H
+#define GOL_HISTORY_H
+
+
+/*******************************************************************************
+    Begin #include statements
+*******************************************************************************/
+
+
+#include <stddef.h>
+
+#include "gol_engine.h"
+
+
+/*******************************************************************************
+    Begin declarations
+*******************************************************************************/
+
+
+// store of past generations of a board of fixed size
+typedef struct GolHistory GolHistory;
+
+// creates a store holding at most capacity generations
+GolHistory *golHistoryCreate(size_t rows, size_t words, size_t capacity,
+                             size_t interval);
+
+// releases a store
+void golHistoryDestroy(GolHistory *history);
+
+// adds a generation, dropping any stored at or after the same generation
+int golHistoryRecord(GolHistory *history, const uLLInt *cells,
+                     unsigned long long generation);
+
+// rebuilds a stored generation, valid until the next call on the store
+const uLLInt *golHistorySeek(GolHistory *history,
+                             unsigned long long generation);
+
+// range of stored generations, number of them and bytes used by their data
+unsigned long long golHistoryOldest(const GolHistory *history);
+unsigned long long golHistoryNewest(const GolHistory *history);
+size_t golHistoryCount(const GolHistory *history);
+size_t golHistoryBytes(const GolHistory *history);
+
+
+#endif
@@ -0,0 +1,894 @@
+/*******************************************************************************
+
+    PURPOSE: Implementation of the simulation server declared in
+             gol_server.h.
+
+    HISTORY: Created for running one simulation shared by several tools.
+
+    ALGORITHM(S): A single thread polls the listening socket and every
+                  connected client. While the board is running, the poll
+                  timeout is the time left until the next step is due.
+
+                  Every completed generation is copied once from the engine
+                  into the next slot of the shared-memory ring. Clients map
+                  the ring and read the rows in place, so the server never
+                  waits on them and never copies a board for them.
+
+                  "step <n>" does not run n steps at once. The steps are owed
+                  and taken a slice of at most GOL_SERVER_SLICE_MS at a time,
+                  one slice per pass of the loop, so other clients are still
+                  served in between. The client that asked is answered once
+                  its steps are done, and its later commands wait until then.
+
+    NOTES: Client sockets are non-blocking. Replies are queued per client and
+           sent as the socket drains. A client whose unsent replies grow
+           past GOL_SERVER_BACKLOG bytes has stopped reading and is
+           disconnected, so it can not hold up the loop.
+
+*******************************************************************************/
+
+/*******************************************************************************
+    Begin #include statements
+*******************************************************************************/
+
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <poll.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "gol_history.h"
+#include "gol_server.h"
+#include "gol_shm.h"
+
+
+/*******************************************************************************
+    Begin #define statements
+*******************************************************************************/
+
+
+// number of clients connected at the same time
+#define GOL_SERVER_CLIENTS 16
+
+// longest command line accepted from a client
+#define GOL_SERVER_LINE 4096
+
+// most bytes of replies queued for a client that is not reading them
+#define GOL_SERVER_BACKLOG (16 * 1024 * 1024)
+
+// longest time spent on owed steps before serving the clients again
+#define GOL_SERVER_SLICE_MS 10
+
+
+/*******************************************************************************
+    Begin declarations
+*******************************************************************************/
+
+
+typedef struct {
+    // connected socket, -1 for a free entry
+    int fd;
+    // entry of the client in the poll() array, -1 if it was not polled
+    int polled;
+    // true once nothing more is read from the client, which is let go as
+    // soon as everything it asked for has been answered
+    int finished;
+    // true once the client has to be disconnected
+    int broken;
+    // bytes of unfinished command lines
+    size_t used;
+    char line[GOL_SERVER_LINE];
+    // queued replies, the first sent bytes of them already written
+    char *out;
+    size_t out_size;
+    size_t out_used;
+    size_t out_sent;
+    // true while waiting for owed steps, until steps_done reaches target
+    int waiting;
+    unsigned long long target;
+} Client;
+
+typedef struct {
+    GolBoard *board;
+    // ring and history, NULL when turned off
+    GolShm *shm;
+    GolHistory *history;
+    // steps asked for with "step" and not taken yet, and those taken so far
+    unsigned long long steps_owed;
+    unsigned long long steps_done;
+    // true while the board steps on its own every interval_ms
+    int running;
+    long interval_ms;
+    // time of the last step taken while running
+    long long last_step_ms;
+    // set by the "stop" command
+    int stopping;
+    Client clients[GOL_SERVER_CLIENTS];
+} Server;
+
+
+static long long nowMs(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (long long)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+/*******************************************************************************
+
+    PURPOSE: To copy the current generation of the board into the ring
+
+    INPUTS: The server.
+
+    OUTPUTS: NONE
+
+*******************************************************************************/
+
+static void publish(Server *server) {
+    if (server->shm == NULL) {
+        return;
+    }
+
+    uLLInt *cells = golShmBeginPublish(server->shm,
+                                       golGeneration(server->board));
+
+    golReadRegion(server->board, 0, golRows(server->board),
+                  0, golWords(server->board), cells);
+    golShmEndPublish(server->shm);
+}
+
+/*******************************************************************************
+
+    PURPOSE: To keep the current generation in the history and publish it
+
+    INPUTS: The server.
+
+    OUTPUTS: NONE, a generation the history could not keep is reported on
+             stderr and is still published.
+
+*******************************************************************************/
+
+static void record(Server *server) {
+    if (server->history != NULL &&
+        golHistoryRecord(server->history, golCells(server->board),
+                         golGeneration(server->board)) != GOL_SUCCESS) {
+        fprintf(stderr, "gol: generation %llu could not be kept in the "
+                "history\n", golGeneration(server->board));
+    }
+    publish(server);
+}
+
+/*******************************************************************************
+
+    PURPOSE: To make room for a reply in the queue of a client
+
+    INPUTS: The client and the number of bytes wanted.
+
+    OUTPUTS: Where the bytes go, to be followed by adding the number written
+             to out_used. NULL if the queue would grow past GOL_SERVER_BACKLOG
+             or memory ran out, in which case the client is marked broken.
+
+*******************************************************************************/
+
+static char *reserve(Client *client, size_t length) {
+    if (client->broken) {
+        return NULL;
+    }
+
+    // move what is left to the front before growing the queue
+    if (client->out_sent > 0) {
+        client->out_used -= client->out_sent;
+        memmove(client->out, client->out + client->out_sent,
+                client->out_used);
+        client->out_sent = 0;
+    }
+
+    if (length > GOL_SERVER_BACKLOG - client->out_used) {
+        client->broken = 1;
+        return NULL;
+    }
+
+    if (client->out_used + length > client->out_size) {
+        size_t size = 2 * client->out_size;
+        if (size < client->out_used + length) {
+            size = client->out_used + length;
+        }
+        if (size > GOL_SERVER_BACKLOG) {
+            size = GOL_SERVER_BACKLOG;
+        }
+        char *out = realloc(client->out, size);
+        if (out == NULL) {
+            client->broken = 1;
+            return NULL;
+        }
+        client->out = out;
+        client->out_size = size;
+    }
+
+    return client->out + client->out_used;
+}
+
+static int reply(Client *client, const char *format, ...) {
+    char buffer[256];
+    va_list args;
+
+    va_start(args, format);
+    int length = vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+
+    if (length < 0) {
+        return -1;
+    }
+    if ((size_t)length >= sizeof(buffer)) {
+        length = sizeof(buffer) - 1;
+    }
+
+    char *out = reserve(client, length);
+    if (out == NULL) {
+        return -1;
+    }
+    memcpy(out, buffer, length);
+    client->out_used += length;
+
+    return 0;
+}
+
+/*******************************************************************************
+
+    PURPOSE: To send as much of the queued replies as the socket takes
+
+    INPUTS: The client.
+
+    OUTPUTS: 0 on success, -1 if the client went away.
+
+*******************************************************************************/
+
+static int flush(Client *client) {
+    while (client->out_sent < client->out_used) {
+        ssize_t sent = send(client->fd, client->out + client->out_sent,
+                            client->out_used - client->out_sent,
+                            MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return 0;
+        }
+        if (sent <= 0) {
+            return -1;
+        }
+        client->out_sent += sent;
+    }
+
+    client->out_used = client->out_sent = 0;
+    // do not keep the room taken by a large query once it is sent
+    if (client->out_size > GOL_SERVER_LINE) {
+        free(client->out);
+        client->out = NULL;
+        client->out_size = 0;
+    }
+
+    return 0;
+}
+
+/*******************************************************************************
+
+    PURPOSE: To disconnect a client
+
+    INPUTS: The client.
+
+    OUTPUTS: NONE
+
+*******************************************************************************/
+
+static void dropClient(Client *client) {
+    close(client->fd);
+    free(client->out);
+    memset(client, 0, sizeof(*client));
+    client->fd = -1;
+    client->polled = -1;
+}
+
+/*******************************************************************************
+
+    PURPOSE: To answer a query command with a region of the board
+
+    INPUTS: The server, the client and the arguments of the command.
+
+    OUTPUTS: 0 on success, -1 if the client has to be disconnected.
+
+    ALGORITHM(S): Copy the region out of the engine, then queue it one row at
+                  a time as hex words, the same format that load reads back.
+                  A region whose text would not fit in GOL_SERVER_BACKLOG is
+                  refused, larger boards are read from the ring instead.
+
+*******************************************************************************/
+
+static int query(Server *server, Client *client, const char *arguments) {
+    size_t first_row, row_count, first_word, word_count;
+    // 16 hex digits and a separator per word
+    size_t most = GOL_SERVER_BACKLOG / 2 / 17;
+
+    if (sscanf(arguments, "%zu %zu %zu %zu", &first_row, &row_count,
+               &first_word, &word_count) != 4 ||
+        row_count == 0 || word_count == 0) {
+        return reply(client,
+                     "error usage: query <row> <rows> <word> <words>\n");
+    }
+    if (row_count > most / word_count) {
+        return reply(client, "error region is over %zu words\n", most);
+    }
+
+    uLLInt *region = malloc(row_count * word_count * sizeof(uLLInt));
+    if (region == NULL) {
+        return reply(client, "error out of memory\n");
+    }
+
+    int result;
+    if (golReadRegion(server->board, first_row, row_count,
+                      first_word, word_count, region) != GOL_SUCCESS) {
+        result = reply(client, "error region is outside the board\n");
+    } else {
+        result = reply(client, "ok %llu %zu %zu\n",
+                       golGeneration(server->board), row_count, word_count);
+
+        size_t row, word;
+        for (row = 0; row < row_count && result == 0; row++) {
+            // the terminating nul of the last sprintf() needs a byte too
+            char *text = reserve(client, word_count * 17 + 1);
+            if (text == NULL) {
+                result = -1;
+                break;
+            }
+            for (word = 0; word < word_count; word++) {
+                client->out_used += sprintf(text + 17 * word, "%016llx%c",
+                                            region[row * word_count + word],
+                                            word + 1 < word_count ?
+                                            ' ' : '\n');
+            }
+        }
+    }
+
+    free(region);
+    return result;
+}
+
+/*******************************************************************************
+
+    PURPOSE: To replace the board with one saved from a query
+
+    INPUTS: The server and the path of a file holding rows * words hex words.
+
+    OUTPUTS: GOL_SUCCESS, or GOL_FAILURE if the file can not be read or holds
+             too few words.
+
+*******************************************************************************/
+
+static int load(Server *server, const char *path) {
+    size_t count = golRows(server->board) * golWords(server->board);
+
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        return GOL_FAILURE;
+    }
+
+    uLLInt *cells = malloc(count * sizeof(uLLInt));
+    size_t i = 0;
+    if (cells != NULL) {
+        while (i < count && fscanf(file, "%llx", &cells[i]) == 1) {
+            i++;
+        }
+    }
+    fclose(file);
+
+    int result = GOL_FAILURE;
+    if (cells != NULL && i == count) {
+        result = golLoadRegion(server->board, 0, golRows(server->board),
+                               0, golWords(server->board), cells);
+    }
+
+    free(cells);
+    return result;
+}
+
+/*******************************************************************************
+
+    PURPOSE: To answer the clients waiting for owed steps
+
+    INPUTS: The server.
+
+    OUTPUTS: NONE
+
+    ALGORITHM(S): answerSteps() answers every client whose steps are done.
+                  cancelSteps() drops the owed steps and tells every waiting
+                  client they were cancelled, for commands that pause or
+                  replace the board.
+
+*******************************************************************************/
+
+static void answerSteps(Server *server) {
+    int i;
+
+    for (i = 0; i < GOL_SERVER_CLIENTS; i++) {
+        Client *client = &server->clients[i];
+        if (client->fd >= 0 && client->waiting &&
+            server->steps_done >= client->target) {
+            client->waiting = 0;
+            reply(client, "ok %llu\n", golGeneration(server->board));
+        }
+    }
+}
+
+static void cancelSteps(Server *server) {
+    int i;
+
+    server->steps_owed = 0;
+    for (i = 0; i < GOL_SERVER_CLIENTS; i++) {
+        Client *client = &server->clients[i];
+        if (client->fd >= 0 && client->waiting) {
+            client->waiting = 0;
+            reply(client, "error steps cancelled at %llu\n",
+                  golGeneration(server->board));
+        }
+    }
+}
+
+/*******************************************************************************
+
+    PURPOSE: To carry out one command line from a client
+
+    INPUTS: The server, the client and the line without its newline.
+
+    OUTPUTS: 0 on success, -1 if the client has to be disconnected.
+
+*******************************************************************************/
+
+static int handleCommand(Server *server, Client *client, const char *line) {
+    char command[16];
+    int offset = 0;
+
+    if (sscanf(line, "%15s %n", command, &offset) != 1) {
+        return 0;
+    }
+    const char *arguments = line + offset;
+
+    if (strcmp(command, "step") == 0) {
+        unsigned long long generations = 1;
+        if (*arguments != '\0' &&
+            (*arguments == '-' ||
+             sscanf(arguments, "%llu", &generations) != 1)) {
+            return reply(client, "error usage: step [n]\n");
+        }
+        if (generations > ULLONG_MAX - server->steps_done -
+                          server->steps_owed) {
+            return reply(client, "error too many steps\n");
+        }
+        if (generations == 0) {
+            return reply(client, "ok %llu\n", golGeneration(server->board));
+        }
+        // answered by answerSteps() once the steps are taken
+        server->steps_owed += generations;
+        client->waiting = 1;
+        client->target = server->steps_done + server->steps_owed;
+        return 0;
+    }
+
+    if (strcmp(command, "run") == 0) {
+        server->running = 1;
+        server->last_step_ms = nowMs();
+        return reply(client, "ok\n");
+    }
+
+    if (strcmp(command, "pause") == 0) {
+        cancelSteps(server);
+        server->running = 0;
+        return reply(client, "ok\n");
+    }
+
+    if (strcmp(command, "seed") == 0) {
+        unsigned long long seed = time(NULL);
+        sscanf(arguments, "%llu", &seed);
+        cancelSteps(server);
+        golSeed(server->board, seed);
+        record(server);
+        return reply(client, "ok %llu\n", golGeneration(server->board));
+    }
+
+    if (strcmp(command, "load") == 0) {
+        if (load(server, arguments) != GOL_SUCCESS) {
+            return reply(client, "error could not load %s\n", arguments);
+        }
+        cancelSteps(server);
+        record(server);
+        return reply(client, "ok %llu\n", golGeneration(server->board));
+    }
+
+    if (strcmp(command, "query") == 0) {
+        return query(server, client, arguments);
+    }
+
+    if (strcmp(command, "status") == 0) {
+        return reply(client, "ok %llu %llu %zu %zu %s\n",
+                     golGeneration(server->board),
+                     server->shm != NULL ? golShmPublished(server->shm) : 0,
+                     golRows(server->board), golWords(server->board),
+                     server->running ? "running" : "paused");
+    }
+
+    if ((strcmp(command, "seek") == 0 || strcmp(command, "history") == 0) &&
+        server->history == NULL) {
+        return reply(client, "error the history is off\n");
+    }
+
+    if (strcmp(command, "seek") == 0) {
+        unsigned long long generation;
+        const uLLInt *cells = NULL;
+        if (sscanf(arguments, "%llu", &generation) == 1) {
+            cells = golHistorySeek(server->history, generation);
+        }
+        if (cells == NULL) {
+            return reply(client, "error generation is not in the history\n");
+        }
+        cancelSteps(server);
+        // the generation is already in the history, only publish it
+        golRestore(server->board, cells, generation);
+        publish(server);
+        return reply(client, "ok %llu\n", golGeneration(server->board));
+    }
+
+    if (strcmp(command, "history") == 0) {
+        return reply(client, "ok %llu %llu %zu %zu\n",
+                     golHistoryOldest(server->history),
+                     golHistoryNewest(server->history),
+                     golHistoryCount(server->history),
+                     golHistoryBytes(server->history));
+    }
+
+    if (strcmp(command, "stop") == 0) {
+        cancelSteps(server);
+        server->stopping = 1;
+        return reply(client, "ok\n");
+    }
+
+    return reply(client, "error unknown command %s\n", command);
+}
+
+/*******************************************************************************
+
+    PURPOSE: To run the complete lines a client has sent
+
+    INPUTS: The server and the client.
+
+    OUTPUTS: 0 on success, -1 if the client has to be disconnected.
+
+    ALGORITHM(S): Lines are run in order until one of them leaves the client
+                  waiting for owed steps. The rest stay buffered and are run
+                  once the client has been answered.
+
+*******************************************************************************/
+
+static int runLines(Server *server, Client *client) {
+    char *newline;
+
+    while (!client->waiting &&
+           (newline = memchr(client->line, '\n', client->used)) != NULL) {
+        *newline = '\0';
+        if (newline > client->line && newline[-1] == '\r') {
+            newline[-1] = '\0';
+        }
+        if (handleCommand(server, client, client->line) != 0) {
+            return -1;
+        }
+
+        size_t consumed = newline + 1 - client->line;
+        client->used -= consumed;
+        memmove(client->line, newline + 1, client->used);
+    }
+
+    // a full buffer without a newline can never become a valid command
+    if (!client->waiting && client->used == sizeof(client->line)) {
+        client->used = 0;
+        client->finished = 1;
+        return reply(client, "error line too long\n");
+    }
+
+    return 0;
+}
+
+/*******************************************************************************
+
+    PURPOSE: To read what a client sent and run every complete line
+
+    INPUTS: The server and the client, with room left in its line buffer.
+
+    OUTPUTS: 0 on success, -1 if the client has to be disconnected.
+
+*******************************************************************************/
+
+static int readClient(Server *server, Client *client) {
+    ssize_t received = recv(client->fd, client->line + client->used,
+                            sizeof(client->line) - client->used, 0);
+    if (received < 0 &&
+        (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)) {
+        return 0;
+    }
+    if (received < 0) {
+        return -1;
+    }
+    if (received == 0) {
+        // answer what was sent before the client hung up its end
+        client->finished = 1;
+    }
+    client->used += received;
+
+    return runLines(server, client);
+}
+
+/*******************************************************************************
+
+    PURPOSE: To create the listening Unix domain socket
+
+    INPUTS: The path of the socket.
+
+    OUTPUTS: The socket, or -1 on failure, or if something other than a
+             socket is in the way at the path.
+
+*******************************************************************************/
+
+static int listenOn(const char *socket_path) {
+    struct sockaddr_un address;
+
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(socket_path) >= sizeof(address.sun_path)) {
+        return -1;
+    }
+    strcpy(address.sun_path, socket_path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+
+    // only a socket left behind by an earlier server may be replaced
+    struct stat info;
+    if (lstat(socket_path, &info) == 0) {
+        if (!S_ISSOCK(info.st_mode) || unlink(socket_path) != 0) {
+            close(fd);
+            return -1;
+        }
+    }
+
+    if (bind(fd, (struct sockaddr *)&address, sizeof(address)) != 0 ||
+        listen(fd, GOL_SERVER_CLIENTS) != 0) {
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+/*******************************************************************************
+
+    PURPOSE: To serve a board
+
+    INPUTS: The board, the path of the Unix domain socket, the name of the
+            shared-memory ring and the options, NULL for the defaults.
+
+    OUTPUTS: GOL_SUCCESS once stopped, GOL_FAILURE if the socket, the ring
+             or the history could not be set up or polling failed.
+
+    ALGORITHM(S): Publish the starting board, then loop polling the listening
+                  socket and the clients until "stop" or options->stop
+                  is set, for example from a signal handler, which also
+                  interrupts poll(). The
+                  board starts paused.
+
+                  Each pass steps the running board if a step is due, takes
+                  a slice of the owed steps, runs the commands that arrived
+                  and sends what the socket of each client will take. A
+                  client is polled for input only while its line buffer has
+                  room, and for output only while it has replies queued.
+
+*******************************************************************************/
+
+int golServe(GolBoard *board, const char *socket_path, const char *shm_name,
+             const GolServerOptions *options) {
+    GolServerOptions defaults = GOL_SERVER_DEFAULTS;
+    Server server;
+    struct pollfd fds[GOL_SERVER_CLIENTS + 1];
+    int i;
+
+    if (options == NULL) {
+        options = &defaults;
+    }
+
+    memset(&server, 0, sizeof(server));
+    server.board = board;
+    server.interval_ms = options->interval_ms > 0 ? options->interval_ms : 1;
+    for (i = 0; i < GOL_SERVER_CLIENTS; i++) {
+        server.clients[i].fd = -1;
+        server.clients[i].polled = -1;
+    }
+
+    if (options->history > 0) {
+        server.history = golHistoryCreate(golRows(board), golWords(board),
+                                          options->history,
+                                          options->keyframes);
+        if (server.history == NULL) {
+            return GOL_FAILURE;
+        }
+    }
+
+    if (options->slots > 0) {
+        server.shm = golShmCreate(shm_name, golRows(board), golWords(board),
+                                  options->slots);
+        if (server.shm == NULL) {
+            golHistoryDestroy(server.history);
+            return GOL_FAILURE;
+        }
+    }
+
+    int listener = listenOn(socket_path);
+    // the socket bound, so that only it is removed again at the end
+    struct stat bound;
+    if (listener >= 0 && lstat(socket_path, &bound) != 0) {
+        close(listener);
+        listener = -1;
+    }
+    if (listener < 0) {
+        golShmClose(server.shm);
+        golHistoryDestroy(server.history);
+        return GOL_FAILURE;
+    }
+
+    record(&server);
+
+    int result = GOL_SUCCESS;
+    while (!server.stopping &&
+           (options->stop == NULL || *options->stop == 0)) {
+        // true if a client has commands to run without reading any more
+        int ready = server.steps_owed > 0;
+
+        int count = 0;
+        fds[count].fd = listener;
+        fds[count++].events = POLLIN;
+        for (i = 0; i < GOL_SERVER_CLIENTS; i++) {
+            Client *client = &server.clients[i];
+            client->polled = -1;
+            if (client->fd < 0) {
+                continue;
+            }
+            client->polled = count;
+            fds[count].fd = client->fd;
+            fds[count].events = 0;
+            if (!client->finished && client->used < sizeof(client->line)) {
+                fds[count].events |= POLLIN;
+            }
+            if (client->out_sent < client->out_used) {
+                fds[count].events |= POLLOUT;
+            }
+            if (!client->waiting &&
+                memchr(client->line, '\n', client->used) != NULL) {
+                ready = 1;
+            }
+            count++;
+        }
+
+        int timeout = -1;
+        if (ready) {
+            timeout = 0;
+        } else if (server.running) {
+            long long due = server.last_step_ms + server.interval_ms - nowMs();
+            timeout = due > 0 ? (int)due : 0;
+        }
+
+        if (poll(fds, count, timeout) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            result = GOL_FAILURE;
+            break;
+        }
+
+        if (server.running &&
+            nowMs() - server.last_step_ms >= server.interval_ms) {
+            golStep(board, 1);
+            record(&server);
+            server.last_step_ms = nowMs();
+        }
+
+        if (server.steps_owed > 0) {
+            long long started = nowMs();
+            do {
+                golStep(board, 1);
+                record(&server);
+                server.steps_owed--;
+                server.steps_done++;
+            } while (server.steps_owed > 0 &&
+                     nowMs() - started < GOL_SERVER_SLICE_MS);
+            answerSteps(&server);
+        }
+
+        for (i = 0; i < GOL_SERVER_CLIENTS; i++) {
+            Client *client = &server.clients[i];
+            if (client->fd < 0) {
+                continue;
+            }
+            short revents = client->polled >= 0 ?
+                            fds[client->polled].revents : 0;
+            if (revents & POLLIN) {
+                if (readClient(&server, client) != 0) {
+                    client->broken = 1;
+                }
+            } else if (revents & (POLLHUP | POLLERR)) {
+                client->broken = 1;
+            } else if (runLines(&server, client) != 0) {
+                // lines left over from a wait that has just been answered
+                client->broken = 1;
+            }
+        }
+
+        // send what each client will take and let go of those that are done
+        for (i = 0; i < GOL_SERVER_CLIENTS; i++) {
+            Client *client = &server.clients[i];
+            if (client->fd < 0) {
+                continue;
+            }
+            if (!client->broken && flush(client) != 0) {
+                client->broken = 1;
+            }
+            if (client->broken ||
+                (client->finished && !client->waiting &&
+                 client->out_sent == client->out_used)) {
+                dropClient(client);
+            }
+        }
+
+        if (fds[0].revents & POLLIN) {
+            int fd = accept(listener, NULL, NULL);
+            if (fd >= 0 && fcntl(fd, F_SETFL, O_NONBLOCK) != 0) {
+                close(fd);
+                fd = -1;
+            }
+            for (i = 0; fd >= 0 && i < GOL_SERVER_CLIENTS; i++) {
+                if (server.clients[i].fd < 0) {
+                    server.clients[i].fd = fd;
+                    fd = -1;
+                }
+            }
+            if (fd >= 0) {
+                const char *full = "error too many clients\n";
+                send(fd, full, strlen(full), MSG_NOSIGNAL);
+                close(fd);
+            }
+        }
+    }
+
+    // a last try at the replies still queued, such as the answer to "stop"
+    for (i = 0; i < GOL_SERVER_CLIENTS; i++) {
+        if (server.clients[i].fd >= 0) {
+            flush(&server.clients[i]);
+            dropClient(&server.clients[i]);
+        }
+    }
+    close(listener);
+    struct stat info;
+    if (lstat(socket_path, &info) == 0 && info.st_dev == bound.st_dev &&
+        info.st_ino == bound.st_ino) {
+        unlink(socket_path);
+    }
+    golShmClose(server.shm);
+    golHistoryDestroy(server.history);
+
+    return result;
+}
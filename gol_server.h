@@ -0,0 +1,105 @@
+/*******************************************************************************
+
+    PURPOSE: Server mode. Runs the stepping loop of one board, takes commands
+             from local clients over a Unix domain socket and publishes every
+             completed generation into a shared-memory ring (gol_shm.h) that
+             viewers, stat collectors and exporters read without copying.
+
+    HISTORY: Created for running one simulation shared by several tools.
+
+    INPUTS: One command per line on the socket, each answered with a line
+            starting with "ok" or "error", in the order they were sent.
+
+                step [n]                   compute n generations (default 1),
+                                           answered once they are done
+                run                        step every interval until paused
+                pause                      stop stepping, cancelling the steps
+                                           still owed to step commands
+                seed [value]               reseed the board (default: time)
+                load <path>                load a board saved from query
+                query <row> <rows> <word> <words>
+                                           "ok <generation> <rows> <words>"
+                                           followed by one line of hex words
+                                           per row, for up to about 490000
+                                           words at a time
+                status                     "ok <generation> <sequence> <rows>
+                                           <words> <running|paused>"
+                seek <generation>          put the board back to a
+                                           generation kept in the history
+                history                    "ok <oldest> <newest> <count>
+                                           <bytes>" of the history
+                stop                       shut the server down
+
+    OUTPUTS: A board in the shared-memory ring for every generation. Every
+             generation is also kept in a history store (gol_history.h) so
+             that the run can be rewound with seek. Either can be turned off
+             with GolServerOptions, status then reports sequence 0 and seek
+             and history answer with an error.
+
+    NOTES: seed, load and seek also cancel the steps still owed. A client
+           that stops reading its replies is disconnected once they pile up
+           past 16 MB.
+
+*******************************************************************************/
+
+#ifndef GOL_SERVER_H
+#define GOL_SERVER_H
+
+
+/*******************************************************************************
+    Begin #include statements
+*******************************************************************************/
+
+
+#include <signal.h>
+
+#include "gol_engine.h"
+
+
+/*******************************************************************************
+    Begin #define statements
+*******************************************************************************/
+
+
+// time between steps while running, in milliseconds, and generations kept
+// in the shared-memory ring
+#define GOL_SERVER_INTERVAL 100
+#define GOL_SERVER_SLOTS    8
+
+// generations kept in the history, and generations between its keyframes
+#define GOL_SERVER_HISTORY   1024
+#define GOL_SERVER_KEYFRAMES 64
+
+// initializer of a GolServerOptions holding the defaults above
+#define GOL_SERVER_DEFAULTS {GOL_SERVER_INTERVAL, GOL_SERVER_SLOTS, \
+                             GOL_SERVER_HISTORY, GOL_SERVER_KEYFRAMES, NULL}
+
+
+/*******************************************************************************
+    Begin declarations
+*******************************************************************************/
+
+
+// how a board is served
+typedef struct {
+    // time between steps while running
+    long interval_ms;
+    // generations kept in the shared-memory ring, 0 for no ring
+    size_t slots;
+    // generations kept in the history, 0 for none, and between its keyframes
+    size_t history;
+    size_t keyframes;
+    // golServe() returns once this is set non-zero, NULL to only stop on
+    // "stop". The library installs no signal handlers of its own.
+    volatile sig_atomic_t *stop;
+} GolServerOptions;
+
+// serves a board until a client sends "stop" or options->stop is set,
+// options NULL for the defaults, shm_name unused without a ring. Only a socket
+// or a ring left behind by an earlier server is replaced, anything else at
+// socket_path or shm_name makes it fail.
+int golServe(GolBoard *board, const char *socket_path, const char *shm_name,
+             const GolServerOptions *options);
+
+
+#endif
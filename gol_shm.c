@@ -0,0 +1,414 @@
+/*******************************************************************************
+
+    PURPOSE: Implementation of the shared-memory ring of board buffers
+             declared in gol_shm.h.
+
+    HISTORY: Created for the simulation server (gol_server.h).
+
+    NOTES: The layout of the mapping is shared between processes, so it only
+           uses fixed size fields and every part of it starts on its own
+           GOL_SHM_ALIGN boundary.
+
+*******************************************************************************/
+
+/*******************************************************************************
+    Begin #include statements
+*******************************************************************************/
+
+
+#include <fcntl.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "gol_shm.h"
+
+
+/*******************************************************************************
+    Begin #define statements
+*******************************************************************************/
+
+
+// identifies a mapping created by golShmCreate(), "GOLSHM01"
+#define GOL_SHM_MAGIC 0x474F4C53484D3031
+
+// alignment of the header, of each slot and of the cells within a slot
+#define GOL_SHM_ALIGN 64
+
+
+/*******************************************************************************
+    Begin declarations
+*******************************************************************************/
+
+
+// start of the mapping
+typedef struct {
+    uLLInt magic;
+    uLLInt rows;
+    uLLInt words;
+    uLLInt slots;
+    // bytes from the start of one slot to the start of the next
+    uLLInt slot_bytes;
+    // number of publications, the latest one is in slot (published - 1)
+    _Atomic uLLInt published;
+} GolShmHeader;
+
+// start of each slot, followed by the cells at GOL_SHM_ALIGN
+typedef struct {
+    // 2p once publication p is complete, odd while it is being written
+    _Atomic uLLInt sequence;
+    uLLInt generation;
+} GolShmSlot;
+
+struct GolShm {
+    // name passed to shm_open(), kept by the producer to unlink it
+    char *name;
+    // true for the producer that created the ring
+    int owner;
+    // the mapping and its length in bytes
+    GolShmHeader *header;
+    size_t length;
+    // publication being written between Begin and End
+    uLLInt pending;
+};
+
+_Static_assert(sizeof(GolShmHeader) <= GOL_SHM_ALIGN, "header too large");
+_Static_assert(sizeof(GolShmSlot) <= GOL_SHM_ALIGN, "slot too large");
+
+
+/*******************************************************************************
+
+    PURPOSE: To find the slot holding a publication
+
+    INPUTS: The mapped header and a publication number, counting from 1.
+
+    OUTPUTS: A pointer to the slot.
+
+*******************************************************************************/
+
+static GolShmSlot *slotOf(const GolShmHeader *header, uLLInt publication) {
+    size_t index = (publication - 1) % header->slots;
+
+    return (GolShmSlot *)((char *)header + GOL_SHM_ALIGN +
+                          index * header->slot_bytes);
+}
+
+static uLLInt *cellsOf(GolShmSlot *slot) {
+    return (uLLInt *)((char *)slot + GOL_SHM_ALIGN);
+}
+
+/*******************************************************************************
+
+    PURPOSE: To remove a ring left behind under a name
+
+    INPUTS: A shared memory name.
+
+    OUTPUTS: NONE
+
+    ALGORITHM(S): Only an object that starts with GOL_SHM_MAGIC is removed.
+                  Anything else under the name is left alone, and creating
+                  the new ring then fails on O_EXCL.
+
+*******************************************************************************/
+
+static void removeStale(const char *name) {
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0) {
+        return;
+    }
+
+    struct stat info;
+    void *base = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && (size_t)info.st_size >= GOL_SHM_ALIGN) {
+        base = mmap(NULL, GOL_SHM_ALIGN, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (base == MAP_FAILED) {
+        return;
+    }
+
+    if (((const GolShmHeader *)base)->magic == GOL_SHM_MAGIC) {
+        shm_unlink(name);
+    }
+    munmap(base, GOL_SHM_ALIGN);
+}
+
+/*******************************************************************************
+
+    PURPOSE: To create the ring
+
+    INPUTS: A shared memory name ("/name"), the board dimensions and the
+            number of slots in the ring.
+
+    OUTPUTS: A handle on the ring, or NULL on failure, including a ring too
+             large to address.
+
+    ALGORITHM(S): Remove a stale ring left under the same name, but nothing
+                  else, then create the object, size it and map it
+                  read-write. ftruncate() leaves
+                  the object zeroed, so every slot starts with sequence 0 and
+                  published starts at 0.
+
+*******************************************************************************/
+
+GolShm *golShmCreate(const char *name, size_t rows, size_t words,
+                     size_t slots) {
+    if (rows == 0 || words == 0 || slots == 0) {
+        return NULL;
+    }
+
+    // a slot is its GOL_SHM_ALIGN header plus the cells, rounded up to
+    // GOL_SHM_ALIGN, after the GOL_SHM_ALIGN ring header
+    if (words > SIZE_MAX / sizeof(uLLInt) / rows ||
+        rows * words * sizeof(uLLInt) > SIZE_MAX - 2 * GOL_SHM_ALIGN) {
+        return NULL;
+    }
+    size_t cell_bytes = rows * words * sizeof(uLLInt);
+    size_t slot_bytes = GOL_SHM_ALIGN + cell_bytes;
+    slot_bytes = (slot_bytes + GOL_SHM_ALIGN - 1) / GOL_SHM_ALIGN *
+                 GOL_SHM_ALIGN;
+    if (slots > (SIZE_MAX - GOL_SHM_ALIGN) / slot_bytes) {
+        return NULL;
+    }
+
+    GolShm *shm = calloc(1, sizeof(*shm));
+    if (shm == NULL) {
+        return NULL;
+    }
+    shm->name = strdup(name);
+    shm->owner = 1;
+    shm->length = GOL_SHM_ALIGN + slots * slot_bytes;
+    if (shm->name == NULL) {
+        free(shm);
+        return NULL;
+    }
+
+    removeStale(name);
+    int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (fd < 0) {
+        free(shm->name);
+        free(shm);
+        return NULL;
+    }
+
+    if (ftruncate(fd, shm->length) != 0) {
+        close(fd);
+        shm_unlink(name);
+        free(shm->name);
+        free(shm);
+        return NULL;
+    }
+
+    void *base = mmap(NULL, shm->length, PROT_READ | PROT_WRITE, MAP_SHARED,
+                      fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        shm_unlink(name);
+        free(shm->name);
+        free(shm);
+        return NULL;
+    }
+
+    shm->header = base;
+    shm->header->rows = rows;
+    shm->header->words = words;
+    shm->header->slots = slots;
+    shm->header->slot_bytes = slot_bytes;
+    shm->header->magic = GOL_SHM_MAGIC;
+
+    return shm;
+}
+
+/*******************************************************************************
+
+    PURPOSE: To map a ring created by another process
+
+    INPUTS: The shared memory name passed to golShmCreate().
+
+    OUTPUTS: A read-only handle on the ring, or NULL if it does not exist or
+             is not a ring.
+
+*******************************************************************************/
+
+GolShm *golShmAttach(const char *name) {
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0) {
+        return NULL;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < GOL_SHM_ALIGN) {
+        close(fd);
+        return NULL;
+    }
+
+    void *base = mmap(NULL, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        return NULL;
+    }
+
+    GolShmHeader *header = base;
+    if (header->magic != GOL_SHM_MAGIC || header->slots == 0 ||
+        header->slot_bytes == 0 ||
+        header->slots > ((size_t)info.st_size - GOL_SHM_ALIGN) /
+                        header->slot_bytes) {
+        munmap(base, info.st_size);
+        return NULL;
+    }
+
+    GolShm *shm = calloc(1, sizeof(*shm));
+    if (shm == NULL) {
+        munmap(base, info.st_size);
+        return NULL;
+    }
+    shm->header = header;
+    shm->length = info.st_size;
+
+    return shm;
+}
+
+/*******************************************************************************
+
+    PURPOSE: To release a ring
+
+    INPUTS: A handle from golShmCreate() or golShmAttach(), or NULL.
+
+    OUTPUTS: NONE
+
+*******************************************************************************/
+
+void golShmClose(GolShm *shm) {
+    if (shm == NULL) {
+        return;
+    }
+
+    munmap(shm->header, shm->length);
+    if (shm->owner) {
+        shm_unlink(shm->name);
+    }
+    free(shm->name);
+    free(shm);
+}
+
+size_t golShmRows(const GolShm *shm) {
+    return shm->header->rows;
+}
+
+size_t golShmWords(const GolShm *shm) {
+    return shm->header->words;
+}
+
+unsigned long long golShmPublished(const GolShm *shm) {
+    return atomic_load_explicit(&shm->header->published,
+                                memory_order_acquire);
+}
+
+/*******************************************************************************
+
+    PURPOSE: To start publishing a generation
+
+    INPUTS: The producer's handle and the generation number being published.
+
+    OUTPUTS: A pointer to rows * words cells to be filled by the caller before
+             calling golShmEndPublish().
+
+    ALGORITHM(S): Mark the next slot as being written with an odd sequence.
+                  The release fence keeps that mark ahead of the writes to
+                  the cells, so a client reading the old contents of the slot
+                  will see the sequence change when it validates.
+
+*******************************************************************************/
+
+uLLInt *golShmBeginPublish(GolShm *shm, unsigned long long generation) {
+    shm->pending = atomic_load_explicit(&shm->header->published,
+                                        memory_order_relaxed) + 1;
+
+    GolShmSlot *slot = slotOf(shm->header, shm->pending);
+    atomic_store_explicit(&slot->sequence, 2 * shm->pending - 1,
+                          memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    slot->generation = generation;
+
+    return cellsOf(slot);
+}
+
+/*******************************************************************************
+
+    PURPOSE: To finish publishing a generation
+
+    INPUTS: The producer's handle.
+
+    OUTPUTS: NONE
+
+    ALGORITHM(S): Mark the slot complete with an even sequence, then advance
+                  published so clients start reading it.
+
+*******************************************************************************/
+
+void golShmEndPublish(GolShm *shm) {
+    GolShmSlot *slot = slotOf(shm->header, shm->pending);
+
+    atomic_store_explicit(&slot->sequence, 2 * shm->pending,
+                          memory_order_release);
+    atomic_store_explicit(&shm->header->published, shm->pending,
+                          memory_order_release);
+}
+
+/*******************************************************************************
+
+    PURPOSE: To find the latest complete generation in the ring
+
+    INPUTS: A client handle, and pointers receiving the publication number and
+            the generation number.
+
+    OUTPUTS: A pointer to the cells of the publication inside the mapping, or
+             NULL if nothing has been published yet. The cells must be
+             checked with golShmReadValid() after they have been used.
+
+    ALGORITHM(S): Load published and the sequence of its slot. If the slot has
+                  already moved on to a later publication, the producer has
+                  gone round the ring in between, so start again.
+
+*******************************************************************************/
+
+const uLLInt *golShmReadBegin(const GolShm *shm, unsigned long long *sequence,
+                              unsigned long long *generation) {
+    for (;;) {
+        uLLInt published = atomic_load_explicit(&shm->header->published,
+                                                memory_order_acquire);
+        if (published == 0) {
+            return NULL;
+        }
+
+        GolShmSlot *slot = slotOf(shm->header, published);
+        if (atomic_load_explicit(&slot->sequence, memory_order_acquire) ==
+            2 * published) {
+            *sequence = published;
+            *generation = slot->generation;
+            return cellsOf(slot);
+        }
+    }
+}
+
+/*******************************************************************************
+
+    PURPOSE: To check that cells read in place were not overwritten
+
+    INPUTS: A client handle and the publication number from golShmReadBegin().
+
+    OUTPUTS: Non-zero if the slot still holds that publication.
+
+*******************************************************************************/
+
+int golShmReadValid(const GolShm *shm, unsigned long long sequence) {
+    GolShmSlot *slot = slotOf(shm->header, sequence);
+
+    atomic_thread_fence(memory_order_acquire);
+    return atomic_load_explicit(&slot->sequence, memory_order_relaxed) ==
+           2 * sequence;
+}
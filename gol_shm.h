@@ -0,0 +1,82 @@
+/*******************************************************************************
+
+    PURPOSE: A ring of board buffers in POSIX shared memory. One producer (the
+             simulation server) publishes every completed generation into the
+             ring, and any number of client processes read the packed uLLInt
+             rows straight out of the mapping without copying them.
+
+    HISTORY: Created for the simulation server (gol_server.h).
+
+    BUILD: cc -c -O2 gol_shm.c, link with -lrt on C libraries that keep
+           shm_open() there.
+
+    ALGORITHM(S): The mapping starts with a GolShmHeader followed by a fixed
+                  number of slots, each holding a sequence word, a generation
+                  number and rows * words cells.
+
+                  Publication p (counting from 1) goes into slot
+                  (p - 1) % slots. The producer sets the slot's sequence to
+                  2p - 1 (odd: being written), fills the cells, sets the
+                  sequence to 2p and finally sets the header's published
+                  counter to p. The producer never waits on a client.
+
+                  A client loads published, reads the cells of its slot in
+                  place and then checks that the slot's sequence is still 2p.
+                  If it is not, the producer has lapped the client and the
+                  data it read must be thrown away.
+
+*******************************************************************************/
+
+#ifndef GOL_SHM_H
+#define GOL_SHM_H
+
+
+/*******************************************************************************
+    Begin #include statements
+*******************************************************************************/
+
+
+#include <stddef.h>
+
+#include "gol_engine.h"
+
+
+/*******************************************************************************
+    Begin declarations
+*******************************************************************************/
+
+
+// handle on a mapped ring, created by the producer or attached by a client
+typedef struct GolShm GolShm;
+
+// creates and maps a new ring, replacing a ring left under the same name but
+// failing if anything else has it
+GolShm *golShmCreate(const char *name, size_t rows, size_t words,
+                     size_t slots);
+
+// maps an existing ring read-only
+GolShm *golShmAttach(const char *name);
+
+// unmaps the ring, the producer also removes its name
+void golShmClose(GolShm *shm);
+
+// dimensions of the boards held by the ring
+size_t golShmRows(const GolShm *shm);
+size_t golShmWords(const GolShm *shm);
+
+// producer: returns the cells of the next slot, to be filled before End
+uLLInt *golShmBeginPublish(GolShm *shm, unsigned long long generation);
+void golShmEndPublish(GolShm *shm);
+
+// number of publications so far
+unsigned long long golShmPublished(const GolShm *shm);
+
+// client: returns the cells of the latest publication, NULL if none yet
+const uLLInt *golShmReadBegin(const GolShm *shm, unsigned long long *sequence,
+                              unsigned long long *generation);
+
+// client: true if the cells returned for sequence were not overwritten
+int golShmReadValid(const GolShm *shm, unsigned long long sequence);
+
+
+#endif
@@ -0,0 +1,257 @@
+/*******************************************************************************
+
+    PURPOSE: Implementation of the storage backends declared in gol_storage.h.
+
+    HISTORY: Created to replace the calloc() of the board buffers in
+             golCreate().
+
+    NOTES: The mmap() backends reserve address space only. Pages are faulted
+           in by whoever touches them first, which is what lets the engine
+           place each band of rows next to the thread that steps it.
+
+*******************************************************************************/
+
+/*******************************************************************************
+    Begin #include statements
+*******************************************************************************/
+
+
+// MAP_ANONYMOUS, MAP_NORESERVE, MAP_HUGETLB, madvise(), MADV_HUGEPAGE and
+// RUSAGE_THREAD
+#define _GNU_SOURCE
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "gol_engine.h"
+#include "gol_storage.h"
+
+
+/*******************************************************************************
+    Begin #define statements
+*******************************************************************************/
+
+
+// size of a transparent or explicit huge page on x86-64 and arm64
+#define GOL_HUGE_PAGE (2 * 1024 * 1024)
+
+
+/*******************************************************************************
+
+    PURPOSE: To map anonymous memory aligned to a huge page
+
+    INPUTS: The length wanted, already a multiple of GOL_HUGE_PAGE.
+
+    OUTPUTS: The mapping, or MAP_FAILED.
+
+    ALGORITHM(S): Transparent huge pages can only back whole, aligned 2 MB
+                  ranges. Map one huge page more than needed, then unmap the
+                  unaligned head and the spare tail.
+
+*******************************************************************************/
+
+static void *mapAligned(size_t length) {
+    char *base = mmap(NULL, length + GOL_HUGE_PAGE, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (base == MAP_FAILED) {
+        return MAP_FAILED;
+    }
+
+    size_t head = (GOL_HUGE_PAGE - (uintptr_t)base % GOL_HUGE_PAGE) %
+                  GOL_HUGE_PAGE;
+    if (head > 0) {
+        munmap(base, head);
+    }
+    munmap(base + head + length, GOL_HUGE_PAGE - head);
+
+    return base + head;
+}
+
+/*******************************************************************************
+
+    PURPOSE: To map a scratch file as the memory of a board
+
+    INPUTS: The path of the file and the length wanted.
+
+    OUTPUTS: The mapping, or MAP_FAILED if the file already exists or can not
+             be created.
+
+    ALGORITHM(S): Create the file, refusing to touch one that is already
+                  there, and size it so it reads as zeroes without any blocks
+                  being written. Once it is mapped, remove its name. The
+                  mapping keeps the file alive, and the space goes back to
+                  the file system when the board is released, even if the
+                  program dies.
+
+*******************************************************************************/
+
+static void *mapFile(const char *path, size_t length) {
+    if (path == NULL) {
+        return MAP_FAILED;
+    }
+
+    int fd = open(path, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0) {
+        return MAP_FAILED;
+    }
+
+    void *base = MAP_FAILED;
+    if (ftruncate(fd, length) == 0) {
+        base = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    unlink(path);
+
+    return base;
+}
+
+/*******************************************************************************
+
+    PURPOSE: To allocate the memory of a board
+
+    INPUTS: The storage to fill in, the options (NULL for the heap) and the
+            number of bytes.
+
+    OUTPUTS: GOL_SUCCESS, or GOL_FAILURE if the backend could not provide the
+             memory.
+
+    ALGORITHM(S): Ask the chosen backend for zeroed memory and record the
+                  time and page faults the allocation itself took. The caller
+                  carries on measuring into the same report while it first
+                  touches the memory.
+
+*******************************************************************************/
+
+int golStorageAlloc(GolStorage *storage, const GolStorageOptions *options,
+                    size_t bytes) {
+    int kind = options != NULL ? options->kind : GOL_STORAGE_HEAP;
+    void *base = NULL;
+
+    storage->base = NULL;
+    storage->length = bytes;
+    storage->report.kind = kind;
+    storage->report.bytes = bytes;
+    storage->report.huge_pages = 0;
+    storage->report.milliseconds = 0;
+    storage->report.minor_faults = 0;
+    storage->report.major_faults = 0;
+
+    golStorageMeasureBegin(&storage->report);
+
+    switch (kind) {
+        case GOL_STORAGE_HEAP:
+            base = calloc(bytes, 1);
+            break;
+        case GOL_STORAGE_ANON:
+            storage->length = (bytes + GOL_HUGE_PAGE - 1) / GOL_HUGE_PAGE *
+                              GOL_HUGE_PAGE;
+            base = mapAligned(storage->length);
+            if (base != MAP_FAILED) {
+                storage->report.huge_pages =
+                    madvise(base, storage->length, MADV_HUGEPAGE) == 0;
+            }
+            break;
+        case GOL_STORAGE_HUGE:
+            storage->length = (bytes + GOL_HUGE_PAGE - 1) / GOL_HUGE_PAGE *
+                              GOL_HUGE_PAGE;
+            base = mmap(NULL, storage->length, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            storage->report.huge_pages = base != MAP_FAILED;
+            break;
+        case GOL_STORAGE_FILE:
+            base = mapFile(options->path, bytes);
+            break;
+        default:
+            base = MAP_FAILED;
+            break;
+    }
+
+    golStorageMeasureEnd(&storage->report);
+
+    if (base == NULL || base == MAP_FAILED) {
+        return GOL_FAILURE;
+    }
+    storage->base = base;
+
+    return GOL_SUCCESS;
+}
+
+/*******************************************************************************
+
+    PURPOSE: To release the memory of a board
+
+    INPUTS: A storage filled in by golStorageAlloc().
+
+    OUTPUTS: NONE
+
+*******************************************************************************/
+
+void golStorageFree(GolStorage *storage) {
+    if (storage->base == NULL) {
+        return;
+    }
+
+    if (storage->report.kind == GOL_STORAGE_HEAP) {
+        free(storage->base);
+    } else {
+        munmap(storage->base, storage->length);
+    }
+    storage->base = NULL;
+}
+
+/*******************************************************************************
+
+    PURPOSE: To measure the cost of some work in a report
+
+    INPUTS: The report.
+
+    OUTPUTS: NONE
+
+    ALGORITHM(S): Begin subtracts the current time and fault counts of the
+                  process from the report, End adds them back, leaving the
+                  difference. Pairs can be repeated to add up several pieces
+                  of work. The fault counts cover the calling thread only, so
+                  other boards being created or stepped at the same time do
+                  not show up in them.
+
+*******************************************************************************/
+
+static void measure(GolStorageReport *report, int sign) {
+    struct timespec now;
+    struct rusage usage;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    getrusage(RUSAGE_THREAD, &usage);
+
+    report->milliseconds += sign * (now.tv_sec * 1000.0 + now.tv_nsec / 1e6);
+    report->minor_faults += sign * usage.ru_minflt;
+    report->major_faults += sign * usage.ru_majflt;
+}
+
+void golStorageMeasureBegin(GolStorageReport *report) {
+    measure(report, -1);
+}
+
+void golStorageMeasureEnd(GolStorageReport *report) {
+    measure(report, 1);
+}
+
+const char *golStorageName(int kind) {
+    switch (kind) {
+        case GOL_STORAGE_HEAP:
+            return "heap";
+        case GOL_STORAGE_ANON:
+            return "anon";
+        case GOL_STORAGE_HUGE:
+            return "huge";
+        case GOL_STORAGE_FILE:
+            return "file";
+        default:
+            return "unknown";
+    }
+}
@@ -0,0 +1,114 @@
+/*******************************************************************************
+
+    PURPOSE: Storage backends for the cell buffers of a board. Lets the owner
+             of a very large board choose how its memory is allocated.
+
+    HISTORY: Created to replace the calloc() of the board buffers in
+             golCreate().
+
+    INPUTS: One of the GOL_STORAGE_* kinds:
+
+                GOL_STORAGE_HEAP   calloc(), as before
+                GOL_STORAGE_ANON   anonymous mmap() aligned for and advised
+                                   to use transparent huge pages
+                GOL_STORAGE_HUGE   anonymous mmap() of explicit huge pages
+                                   (MAP_HUGETLB), fails if none are reserved
+                GOL_STORAGE_FILE   shared mmap() of a scratch file, for boards
+                                   larger than RAM. The file must not exist
+                                   yet, and it is removed again as soon as
+                                   it is mapped.
+
+    OUTPUTS: A GolStorageReport with the time taken and the page faults seen
+             while the memory was allocated and first touched. Only the
+             faults of the thread creating the board and of the board's own
+             workers are counted, not those of other threads in the process.
+
+    NOTES: Placement on NUMA machines is done by the engine: the worker
+           thread that owns a band of rows is the first to touch the pages of
+           that band (see golCreateWith() in gol_engine.h). That only holds
+           while the workers stay where they are, so set pin for it. Boards
+           sharing a process should each be given their own first_cpu, or
+           their workers all pin to the same CPUs.
+
+*******************************************************************************/
+
+#ifndef GOL_STORAGE_H
+#define GOL_STORAGE_H
+
+
+/*******************************************************************************
+    Begin #include statements
+*******************************************************************************/
+
+
+#include <stddef.h>
+
+
+/*******************************************************************************
+    Begin #define statements
+*******************************************************************************/
+
+
+// storage kinds
+#define GOL_STORAGE_HEAP 0
+#define GOL_STORAGE_ANON 1
+#define GOL_STORAGE_HUGE 2
+#define GOL_STORAGE_FILE 3
+
+
+/*******************************************************************************
+    Begin declarations
+*******************************************************************************/
+
+
+// how a board's memory should be allocated and stepped
+typedef struct {
+    // one of the GOL_STORAGE_* kinds
+    int kind;
+    // file backing the board for GOL_STORAGE_FILE
+    const char *path;
+    // worker threads, each owning a band of rows, 0 or 1 for none, at most
+    // one per CPU the process may run on
+    size_t threads;
+    // true to pin worker i to the CPU first_cpu + i, counted among the CPUs
+    // the process may run on and wrapping around, false to leave the workers
+    // to the scheduler
+    int pin;
+    size_t first_cpu;
+} GolStorageOptions;
+
+// cost of allocating a board's memory
+typedef struct {
+    int kind;
+    size_t bytes;
+    // true if huge pages were requested and granted
+    int huge_pages;
+    double milliseconds;
+    long minor_faults;
+    long major_faults;
+} GolStorageReport;
+
+// a block of memory obtained from one of the backends
+typedef struct {
+    void *base;
+    size_t length;
+    GolStorageReport report;
+} GolStorage;
+
+// allocates bytes of zeroed memory, GOL_SUCCESS or GOL_FAILURE
+int golStorageAlloc(GolStorage *storage, const GolStorageOptions *options,
+                    size_t bytes);
+
+// releases the memory of a storage
+void golStorageFree(GolStorage *storage);
+
+// starts and stops measuring the time and the calling thread's page faults
+// in a report
+void golStorageMeasureBegin(GolStorageReport *report);
+void golStorageMeasureEnd(GolStorageReport *report);
+
+// name of a storage kind: "heap", "anon", "huge" or "file"
+const char *golStorageName(int kind);
+
+
+#endif
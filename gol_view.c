@@ -0,0 +1,172 @@
+/*******************************************************************************
+
+    PURPOSE: Implementation of the viewport renderer declared in gol_view.h.
+
+    HISTORY: Created by generalizing displayBinary() from gol.c.
+
+    ALGORITHM(S): For every character of the screen, find the block of cells
+                  it covers. For each row of the block, mask off the words
+                  holding the block's columns and popcount them, so 64 cells
+                  are counted at a time instead of one.
+
+                  Every row and word of a block is counted, so a single live
+                  cell anywhere in it still shows. Drawing the whole board
+                  reads each of its words once per frame.
+
+*******************************************************************************/
+
+/*******************************************************************************
+    Begin #include statements
+*******************************************************************************/
+
+
+#include <stdlib.h>
+
+#include "gol_view.h"
+
+
+/*******************************************************************************
+    Begin #define statements
+*******************************************************************************/
+
+
+// LMASK checks the left-most bit
+#define LMASK 0x8000000000000000
+
+// every cell of a word
+#define FULL  0xFFFFFFFFFFFFFFFF
+
+// density glyphs from an empty block to a full one
+#define GLYPHS " .:-=+*#%@"
+#define GLYPH_COUNT (sizeof(GLYPHS) - 1)
+
+
+/*******************************************************************************
+
+    PURPOSE: To find the zoom that shows a whole board
+
+    INPUTS: The size of the board in cells and of the screen in characters.
+
+    OUTPUTS: The smallest zoom, at least 1, at which the board fits.
+
+*******************************************************************************/
+
+size_t golViewFit(size_t rows, size_t columns, size_t height, size_t width) {
+    size_t zoom = 1;
+
+    if (height > 0 && (rows + height - 1) / height > zoom) {
+        zoom = (rows + height - 1) / height;
+    }
+    if (width > 0 && (columns + width - 1) / width > zoom) {
+        zoom = (columns + width - 1) / width;
+    }
+
+    return zoom;
+}
+
+/*******************************************************************************
+
+    PURPOSE: To count the live cells in a slice of a row
+
+    INPUTS: A packed row, and the first column and one past the last column
+            of the slice.
+
+    OUTPUTS: The number of live cells in the slice.
+
+    ALGORITHM(S): Walk the words covering the slice. Mask off the cells of the
+                  first and last word that fall outside the slice and popcount
+                  the rest.
+
+*******************************************************************************/
+
+static size_t countSlice(const uLLInt *row, size_t first, size_t end) {
+    size_t first_word = first / GOL_WORD_BITS;
+    size_t last_word = (end - 1) / GOL_WORD_BITS;
+    size_t live = 0;
+    size_t word;
+
+    for (word = first_word; word <= last_word; word++) {
+        uLLInt MASK = FULL;
+
+        if (word == first_word) {
+            MASK &= FULL >> (first % GOL_WORD_BITS);
+        }
+        if (word == last_word && end % GOL_WORD_BITS != 0) {
+            MASK &= ~(FULL >> (end % GOL_WORD_BITS));
+        }
+
+        live += __builtin_popcountll(row[word] & MASK);
+    }
+
+    return live;
+}
+
+/*******************************************************************************
+
+    PURPOSE: To draw a window onto a board
+
+    INPUTS: The packed cells of the board, its rows and words per row, the
+            viewport and the stream to draw on.
+
+    OUTPUTS: NONE
+
+    ALGORITHM(S): At zoom 1, output an 'x' for a live cell and a space for a
+                  dead one. Otherwise count the live cells of the block behind
+                  each character with countSlice() and pick the glyph matching
+                  its density. Any live cell at all gives a visible glyph.
+
+                  Characters beyond the edge of the board are left blank.
+                  Each line is built in a buffer and written in one go.
+
+*******************************************************************************/
+
+void golRenderViewport(const uLLInt *cells, size_t rows, size_t words,
+                       const GolViewport *view, FILE *out) {
+    size_t columns = words * GOL_WORD_BITS;
+    size_t zoom = view->zoom > 0 ? view->zoom : 1;
+    size_t line, x, i;
+
+    char *text = malloc(view->width + 1);
+    if (text == NULL) {
+        return;
+    }
+
+    for (line = 0; line < view->height; line++) {
+        size_t top = view->row + line * zoom;
+
+        for (x = 0; x < view->width; x++) {
+            size_t left = view->column + x * zoom;
+
+            text[x] = ' ';
+            if (top >= rows || left >= columns) {
+                continue;
+            }
+
+            if (zoom == 1) {
+                uLLInt MASK = LMASK >> (left % GOL_WORD_BITS);
+                // output an X if the bit is 1, otherwise a space if it is 0
+                text[x] = (cells[top * words + left / GOL_WORD_BITS] & MASK) ?
+                          'x' : 0x20;
+                continue;
+            }
+
+            size_t bottom = top + zoom < rows ? top + zoom : rows;
+            size_t right = left + zoom < columns ? left + zoom : columns;
+            size_t counted = (bottom - top) * (right - left);
+            size_t live = 0;
+
+            for (i = top; i < bottom; i++) {
+                live += countSlice(cells + i * words, left, right);
+            }
+
+            if (live > 0) {
+                text[x] = GLYPHS[1 + live * (GLYPH_COUNT - 2) / counted];
+            }
+        }
+
+        text[view->width] = '\n';
+        fwrite(text, 1, view->width + 1, out);
+    }
+
+    free(text);
+}
@@ -0,0 +1,59 @@
+/*******************************************************************************
+
+    PURPOSE: Viewport renderer for boards far larger than the terminal. Draws
+             a pan/zoom window onto a board, where every character on screen
+             stands for a zoom x zoom block of cells.
+
+    HISTORY: Created by generalizing displayBinary() from gol.c.
+
+    OUTPUTS: At zoom 1 a live cell is drawn as 'x' and a dead cell as ' ',
+             as displayBinary() did. Zoomed out, each block is drawn as a
+             density glyph, from ' ' for an empty block to '@' for a full
+             one.
+
+    NOTES: The renderer reads packed rows, so it can draw straight from
+           golCells() or from a slot of the shared-memory ring (gol_shm.h).
+
+*******************************************************************************/
+
+#ifndef GOL_VIEW_H
+#define GOL_VIEW_H
+
+
+/*******************************************************************************
+    Begin #include statements
+*******************************************************************************/
+
+
+#include <stddef.h>
+#include <stdio.h>
+
+#include "gol_engine.h"
+
+
+/*******************************************************************************
+    Begin declarations
+*******************************************************************************/
+
+
+// window onto a board
+typedef struct {
+    // board cell shown in the top-left character of the screen
+    size_t row;
+    size_t column;
+    // board cells per character, along each axis
+    size_t zoom;
+    // size of the screen in characters
+    size_t height;
+    size_t width;
+} GolViewport;
+
+// smallest zoom that fits a whole board of rows x columns on the screen
+size_t golViewFit(size_t rows, size_t columns, size_t height, size_t width);
+
+// draws the viewport onto out, one line per screen row
+void golRenderViewport(const uLLInt *cells, size_t rows, size_t words,
+                       const GolViewport *view, FILE *out);
+
+
+#endif